@@ -37,6 +37,8 @@ namespace esl {
 
     agent::agent(identity<agent> i)
     : entity<agent>(std::move(i)), communicator()
+    , execution(concurrent)
+    , activation(on_event)
     {
 
     }
@@ -45,6 +47,8 @@ namespace esl {
     : entity<agent>(o.identifier)
     , interaction::communicator(o.schedule)
     , data::producer()
+    , execution(o.execution)
+    , activation(o.activation)
     {
 
     }
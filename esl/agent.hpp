@@ -25,17 +25,26 @@
 #ifndef ESL_AGENT_HPP
 #define ESL_AGENT_HPP
 
+#include <limits>
 #include <utility>
 
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 
+#include <esl/computation/timing.hpp>
 #include <esl/data/producer.hpp>
 #include <esl/interaction/communicator.hpp>
+#include <esl/simulation/agent_handle.hpp>
 #include <esl/simulation/entity.hpp>
 #include <esl/simulation/identity.hpp>
+#include <esl/simulation/time.hpp>
 
 
+namespace esl::simulation {
+    class agent_collection;
+    class model;
+}
+
 namespace esl {
     class agent
     : public entity<agent>
@@ -43,10 +52,90 @@ namespace esl {
     , public data::producer
     {
     protected:
+        friend class simulation::agent_collection;
+        friend class simulation::model;
+
+        ///
+        /// \brief  Bookkeeping for models that activate agents by event,
+        ///         maintained by the model and the agent collection.
+        ///
+        struct wakeup_state
+        {
+            ///
+            /// \brief  The next event the agent asked for in its last round
+            ///
+            simulation::time_point scheduled =
+                std::numeric_limits<simulation::time_point>::max();
+
+            ///
+            /// \brief  Set while the agent is selected to run in the current
+            ///         round, so that it is selected once.
+            ///
+            bool queued = false;
+        } wakeup_;
+
+        ///
+        /// \brief  Index of the agent in the local agent collection, set when
+        ///         the agent is activated. Not copied or serialized.
+        ///
+        simulation::agent_handle handle_ = simulation::invalid_handle;
+
     private:
         friend class boost::serialization::access;
 
     public:
+        ///
+        /// \brief  How the agent may be run when the model uses multiple
+        ///         threads.
+        ///
+        /// \details    By default, agents run concurrently with all other
+        ///             agents, and may only modify their own state and
+        ///             outbox. Agents that read or write state shared with
+        ///             other agents (for example by creating new agents in the
+        ///             model's agent collection, or through global variables)
+        ///             must set `serialized`, in which case the model runs
+        ///             at most one serialized agent at a time. Serialized
+        ///             agents still run concurrently with `concurrent` agents.
+        ///
+        enum execution_policy
+        { concurrent = 0
+        , serialized = 1
+        } execution;
+
+        ///
+        /// \brief  Time spent on this agent, measured by the model when it
+        ///         schedules agents by their cost, or when the environment
+        ///         balances load between processes.
+        ///
+        computation::agent_timing timing;
+
+        ///
+        /// \return    The agent's dense handle in the local agent collection,
+        ///            or `simulation::invalid_handle` if it is not active here
+        ///
+        [[nodiscard]] simulation::agent_handle handle() const
+        {
+            return handle_;
+        }
+
+        ///
+        /// \brief  Whether the agent runs only when it has a due event, or
+        ///         every round. Only applies to models that activate agents
+        ///         by event (see `simulation::model::activation`), otherwise
+        ///         all agents run every round.
+        ///
+        /// \details    With `on_event`, the agent runs in a round when it has
+        ///             received messages since it last ran, or when the round
+        ///             has reached the time it returned from its last `act`.
+        ///             Agents that need to observe every round, for example
+        ///             because they inspect shared state, use `every_round`.
+        ///             Must be set in the constructor.
+        ///
+        enum activation_policy
+        { on_event    = 0
+        , every_round = 1
+        } activation;
+
         ///
         /// \brief  agent default constructor
         ///
@@ -101,6 +190,13 @@ namespace esl {
             archive &BOOST_SERIALIZATION_BASE_OBJECT_NVP(
                 interaction::communicator);
             archive &BOOST_SERIALIZATION_BASE_OBJECT_NVP(data::producer);
+            // migrated agents keep their measured cost
+            archive &BOOST_SERIALIZATION_NVP(timing);
+            // and how they are run, when it was set after construction
+            archive &BOOST_SERIALIZATION_NVP(execution);
+            archive &BOOST_SERIALIZATION_NVP(activation);
+            archive &boost::serialization::make_nvp("scheduled",
+                                                    wakeup_.scheduled);
         }
     };
 
@@ -27,7 +27,13 @@
 #ifndef ESL_BLOCK_POOL_HPP
 #define ESL_BLOCK_POOL_HPP
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <stdexcept>
 #include <vector>
@@ -45,7 +51,7 @@ namespace esl::computation::block_pool {
         /// \brief  Used to track overwriting/deleting non-existing items
         ///         in debug mode
         ///
-        bool set;
+        bool set = false;
 #endif
         ///
         /// \brief  The contained value
@@ -58,26 +64,46 @@ namespace esl::computation::block_pool {
         typedef std::uint64_t index_t;
 
         ///
-        /// \brief  The index associated with this block
+        /// \brief  The index of the element in this block, or the maximum
+        ///         index when the block is free
         ///
-        index_t index;
+        index_t index = std::numeric_limits<index_t>::max();
+
+        ///
+        /// \brief  Number of times the block was used, which makes the
+        ///         indices of successive elements in the block unique
+        ///
+        std::uint32_t round = 0;
+
+        ///
+        /// \brief  Position of the block over all chunks of the pool
+        ///
+        std::uint32_t position = 0;
 
         ///
         /// \brief  A pointer to the next free block
         ///
-        block *empty;
+        block *empty = nullptr;
     };
 
     ///
     /// \brief   This memory data-structure provides constant time
     ///          insertion/deletion/indexing
-    ///          while maintaining unique strictly increasing indices
+    ///          while maintaining unique indices
+    ///
+    /// \details    Blocks are allocated in chunks that are never moved, so
+    ///             that pointers to blocks stay valid while the pool grows.
+    ///             Every chunk is twice the size of the chunk before it.
+    ///             An index holds the block's round in the upper half and
+    ///             the block's position in the lower half, so that indices
+    ///             of erased elements are never found again.
     ///
+    ///             The pool is not thread-safe. Threads that share a pool
+    ///             each use a `local_free_list`, which only synchronises
+    ///             with the pool to exchange batches of blocks.
     ///
-    /// \tparam capacity
     /// \tparam element_t_
     template< typename element_t_
-            //, size_t capacity_
             , typename index_t_ = std::uint64_t
             >
     class static_block_pool
@@ -91,48 +117,190 @@ namespace esl::computation::block_pool {
         typedef value_type *pointer;
         typedef const value_type *const_pointer;
         typedef index_t_ index;
+        typedef block<element_t_> block_type;
+
+        class local_free_list;
 
     private:
+        ///
+        /// \brief  Number of bits of an index used for the position
+        ///
+        constexpr static const unsigned int offset_bits_ = sizeof(index) * 4;
+
+        constexpr static const index offset_mask_ =
+            (index(1) << offset_bits_) - 1;
+
+        ///
+        /// \brief  Chunk `k` holds `first_chunk_ << k` blocks. Chunks are
+        ///         not stored in a vector, so that threads can look up
+        ///         blocks while another thread adds a chunk.
+        ///
+        std::array<std::unique_ptr<block_type[]>, 64> chunks_;
+
+        ///
+        /// \brief  Number of allocated chunks
+        ///
+        size_type chunk_count_;
 
         ///
-        /// \brief  Underlying container
+        /// \brief  Number of blocks in the first chunk
         ///
-        std::vector<block<element_t_>> blocks;
+        size_type first_chunk_;
+
+        ///
+        /// \brief  Total number of blocks in all chunks, published after a
+        ///         new chunk is set up
+        ///
+        std::atomic<size_type> capacity_;
 
         ///
         /// \brief  Points to first free element
         ///
-        block<element_t_> *end;
+        block_type *end;
 
         ///
-        /// \brief  Because indices are increasing and unique, index values can
-        ///         take on values (round_ * capacity_) + offset with
-        ///         0 <= offset < capacity_
+        /// \brief  Number of active element in the container. Local free
+        ///         lists add their changes when they exchange blocks.
         ///
-        index round_;
+        std::atomic<size_type> size_;
 
         ///
-        /// \brief
+        /// \brief  Changes the size from the pool's own thread, without
+        ///         the cost of an atomic read-modify-write
         ///
-        index back_;
+        void add_size(difference_type change)
+        {
+            size_.store(size_.load(std::memory_order_relaxed) + change,
+                        std::memory_order_relaxed);
+        }
 
         ///
-        /// \brief  Number of active element in the container.
+        /// \brief  Guards the free list and chunks when blocks are exchanged
+        ///         with local free lists
         ///
-        size_type size_;
+        std::mutex mutex_;
 
-    public:
-        static_block_pool(size_t capacity)
-        : blocks(capacity, block<element_t_>())
+        static unsigned int highest(std::uint64_t w)
         {
-            blocks[capacity - 1].empty = nullptr;
-            for(size_t i = 1; i < capacity; ++i){
-                blocks[capacity - 1 - i].empty = &blocks[capacity - i];
+#if defined(__GNUC__) || defined(__clang__)
+            return 63u - unsigned(__builtin_clzll(w));
+#else
+            unsigned int i = 0;
+            while(w >>= 1) {
+                ++i;
             }
-            end     = &blocks[0];
-            round_  = 0;
-            back_   = 0;
-            size_   = 0;
+            return i;
+#endif
+        }
+
+        ///
+        /// \brief  The block at the position held in the index
+        ///
+        /// \return nullptr if no block was allocated at the position
+        block_type *locate(index i) const
+        {
+            auto offset_ = size_type(i & offset_mask_);
+            if(offset_ >= capacity_.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            // chunk k holds positions from first_chunk_ * (2^k - 1)
+            auto k_ = highest(offset_ / first_chunk_ + 1);
+            return &chunks_[k_][offset_ - first_chunk_ * ((size_type(1) << k_) - 1)];
+        }
+
+        ///
+        /// \brief  Allocates the next chunk, and adds its blocks to the free
+        ///         list
+        ///
+        void grow()
+        {
+            size_type blocks_ = first_chunk_ << chunk_count_;
+            size_type first_ = capacity_.load(std::memory_order_relaxed);
+            if(chunk_count_ >= chunks_.size()
+               || first_ + blocks_ > size_type(offset_mask_)) {
+                throw std::length_error("block_pool container at maximum capacity");
+            }
+            auto &chunk_ = chunks_[chunk_count_];
+            chunk_ = std::make_unique<block_type[]>(blocks_);
+            for(size_type i = 0; i < blocks_; ++i) {
+                chunk_[i].position = std::uint32_t(first_ + i);
+                chunk_[i].empty = (i + 1 < blocks_) ? &chunk_[i + 1] : end;
+            }
+            end = &chunk_[0];
+            ++chunk_count_;
+            capacity_.store(first_ + blocks_, std::memory_order_release);
+        }
+
+        ///
+        /// \brief  Takes a free block, growing the pool when allowed
+        ///
+        block_type *acquire()
+        {
+            if(!end) {
+                if(!growable) {
+                    throw std::length_error("block_pool container at capacity");
+                }
+                grow();
+            }
+            auto *i = end;
+            end = end->empty;
+            return i;
+        }
+
+        ///
+        /// \brief  Gives the block an element and a new index
+        ///
+        std::pair<index, block_type *> assign(block_type *i, const element_t_ &e)
+        {
+#if DEBUG
+            if(i->set) {
+                throw std::logic_error("trying to insert on existing element");
+            }
+            i->set = true;
+#endif
+            i->data = e;
+            i->index = (index(i->round) << offset_bits_) | index(i->position);
+            return {i->index, i};
+        }
+
+        ///
+        /// \brief  Returns the block of a valid index to the free state
+        ///
+        block_type *release(index i)
+        {
+            block_type *removed_ = locate(i);
+#if DEBUG
+            if(!removed_ || removed_->index != i || !removed_->set) {
+                throw std::logic_error("trying to erase non-existing element");
+            }
+            removed_->set = false;
+#endif
+            removed_->index = std::numeric_limits<
+                typename block_type::index_t>::max();
+            ++removed_->round;
+            return removed_;
+        }
+
+    public:
+        ///
+        /// \brief  Whether the pool allocates a new chunk when it is full,
+        ///         instead of throwing `std::length_error`
+        ///
+        bool growable;
+
+        ///
+        /// \param capacity Number of blocks allocated up front, and the size
+        ///                 of the first chunk
+        /// \param growable Whether the pool grows when full
+        static_block_pool(size_t capacity, bool growable = false)
+        : chunk_count_(0)
+        , first_chunk_(std::max<size_t>(1, capacity))
+        , capacity_(0)
+        , end(nullptr)
+        , size_(0)
+        , growable(growable)
+        {
+            grow();
         }
 
         ~static_block_pool() = default;
@@ -144,16 +312,17 @@ namespace esl::computation::block_pool {
         /// \return
         [[nodiscard]] size_type size() const
         {
-            return size_;
+            return size_.load(std::memory_order_relaxed);
         }
 
         ///
-        /// \brief  maximum number of elements that fit in the data structure
+        /// \brief  number of elements that fit in the data structure before
+        ///         it has to grow
         ///
         /// \return
         [[nodiscard]] size_type capacity() const
         {
-            return blocks.size();
+            return capacity_.load(std::memory_order_relaxed);
         }
 
         ///
@@ -161,38 +330,11 @@ namespace esl::computation::block_pool {
         ///
         /// \param e
         /// \return iterator pointing at the element
-        std::pair<index, block<element_t_> *> emplace(const element_t_ &e)
+        std::pair<index, block_type *> emplace(const element_t_ &e)
         {
-            if(size_ >= capacity()) {
-                throw std::length_error("block_pool container at capacity");
-            }
-#if DEBUG
-            if(end->set) {
-                throw std::logic_error("trying to insert on existing element");
-            }
-            end->set = true;
-#endif
-            auto i        = end;
-            i->data       = e;
-            // the offset is the number of positions since the start of the pool
-            size_t offset_ = i - blocks.data();
-
-            if(back_ > offset_) {
-                ++round_;
-                back_ = offset_;
-            }else{
-                ++back_;
-            }
-
-            if(back_ > capacity()) {
-                ++round_;
-                back_ = 0;
-            }
-
-            end = end->empty;
-            ++size_;
-
-            return {round_ * capacity() + offset_, i};
+            auto result_ = assign(acquire(), e);
+            add_size(1);
+            return result_;
         }
 
         ///
@@ -205,53 +347,140 @@ namespace esl::computation::block_pool {
             noexcept
 #endif
         {
-            block<element_t_> *removed_ = &blocks[i % capacity()];
-
-#if DEBUG
-            if(!removed->set) {
-                throw std::exception("trying to erase non-existing element");
-            }
-            removed->set = false;
-#endif
+            auto *removed_ = release(i);
             removed_->empty = end;
             end             = removed_;
+            add_size(-1);
+            return 1;
+        }
 
-            if(size_ == 0){
-#if DEBUG
-                throw std::exception("trying to erase non-existing element");
-#else
-                return 0;
-#endif
+        ///
+        /// \brief  The block holding the element with index `i`
+        ///
+        /// \return nullptr if the element was erased
+        block_type *find(index i) const
+        {
+            auto *block_ = locate(i);
+            return (block_ && block_->index == i) ? block_ : nullptr;
+        }
+
+        reference operator [] (index i)
+        {
+            return locate(i)->data;
+        }
+
+        const_reference operator [] (index i) const
+        {
+            return locate(i)->data;
+        }
+
+        reference at(index i)
+        {
+            auto *block_ = find(i);
+            if(!block_) {
+                throw std::out_of_range("block_pool has no element at index");
             }
+            return block_->data;
+        }
 
-            --size_;
-            return 1;
+        const_reference at(index i) const
+        {
+            auto *block_ = find(i);
+            if(!block_) {
+                throw std::out_of_range("block_pool has no element at index");
+            }
+            return block_->data;
         }
+    };
 
-        constexpr reference operator [] (index i)
+    ///
+    /// \brief  Free blocks held by one thread. Elements are placed in and
+    ///         erased from these blocks without synchronisation, and blocks
+    ///         move to and from the shared pool in batches.
+    ///
+    /// \details    Elements may be erased by another thread's list than the
+    ///             one that placed them. Remaining blocks return to the pool
+    ///             when the list is destroyed. The size of the pool includes
+    ///             the changes of a list once it exchanges blocks with the
+    ///             pool.
+    ///
+    template<typename element_t_, typename index_t_>
+    class static_block_pool<element_t_, index_t_>::local_free_list
+    {
+        static_block_pool &pool_;
+
+        block_type *free_ = nullptr;
+
+        size_type count_ = 0;
+
+        size_type batch_;
+
+        ///
+        /// \brief  Elements placed minus elements erased since the size of
+        ///         the pool was last updated
+        ///
+        difference_type placed_ = 0;
+
+        ///
+        /// \brief  Returns `n` blocks from the front of the list to the pool
+        ///
+        void give_back(size_type n)
+        {
+            std::lock_guard<std::mutex> lock_(pool_.mutex_);
+            pool_.size_.fetch_add(placed_, std::memory_order_relaxed);
+            placed_ = 0;
+            for(; 0 < n && free_; --n, --count_) {
+                auto *i = free_;
+                free_ = free_->empty;
+                i->empty = pool_.end;
+                pool_.end = i;
+            }
+        }
+
+    public:
+        explicit local_free_list(static_block_pool &pool, size_type batch = 64)
+        : pool_(pool)
+        , batch_(std::max<size_type>(1, batch))
         {
-            return blocks[i % capacity()].data;
+
         }
 
-        constexpr const_reference operator [] (index i) const
+        local_free_list(const local_free_list &) = delete;
+
+        ~local_free_list()
         {
-            return this->operator[](i);
+            give_back(count_);
         }
 
-        constexpr reference at(index i)
+        std::pair<index, block_type *> emplace(const element_t_ &e)
         {
-            block<element_t_> *element_ = blocks[i % capacity()];
-#if DEBUG
-            if(!element_->set) {
-                throw std::exception("trying to access non-existing element");
+            if(!free_) {
+                std::lock_guard<std::mutex> lock_(pool_.mutex_);
+                pool_.size_.fetch_add(placed_, std::memory_order_relaxed);
+                placed_ = 0;
+                for(; count_ < batch_; ++count_) {
+                    auto *i = pool_.acquire();
+                    i->empty = free_;
+                    free_ = i;
+                }
             }
-#endif
-            return *element_;
+            auto *i = free_;
+            free_ = free_->empty;
+            --count_;
+            ++placed_;
+            return pool_.assign(i, e);
         }
 
-        constexpr const_reference at(index i) const
+        size_type erase(index i)
         {
-            return at(i);
+            auto *removed_ = pool_.release(i);
+            removed_->empty = free_;
+            free_ = removed_;
+            --placed_;
+            if(++count_ >= 2 * batch_) {
+                give_back(batch_);
+            }
+            return 1;
         }
     };
 }
@@ -0,0 +1,181 @@
+/// \file   checkpoint.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <esl/computation/checkpoint.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/unordered_set.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/exception.hpp>
+#include <esl/simulation/model.hpp>
+
+
+namespace esl::computation {
+
+    namespace {
+        ///
+        /// \brief  Identifies snapshot files, and the version of their layout
+        ///
+        const std::string magic_ = "esl checkpoint";
+
+        constexpr std::uint32_t version_ = 2;
+    }
+
+    checkpoint::~checkpoint()
+    {
+        if(writing_.valid()) {
+            writing_.wait();
+        }
+    }
+
+    void checkpoint::start(simulation::time_point time)
+    {
+        next_ = time + interval;
+    }
+
+    bool checkpoint::due(simulation::time_point time) const
+    {
+        return enabled() && 0 < interval && next_ <= time;
+    }
+
+    void checkpoint::save( simulation::model &simulation
+                         , simulation::time_point time
+                         , const std::string &file)
+    {
+        std::ostringstream stream_(std::ios::binary);
+        {
+            boost::archive::binary_oarchive archive_(stream_);
+            archive_ << magic_ << version_ << time;
+            archive_ << simulation.rounds_;
+            archive_ << simulation.world;
+
+            // in slot order, so that restored agents run in the same order
+            std::vector<std::shared_ptr<agent>> agents_;
+            std::vector<std::uint8_t> woken_;
+            for(auto *a : simulation.agents.slots()) {
+                if(nullptr != a) {
+                    agents_.push_back(simulation.agents.local_agents_[a->identifier]);
+                    woken_.push_back(simulation.agents.woken(*a));
+                }
+            }
+            archive_ << agents_ << woken_;
+            archive_ << simulation.agents.global_agents_;
+            simulation.save_state(archive_);
+        }
+        next_ = time + interval;
+
+        wait();
+        writing_ = std::async(std::launch::async,
+            [file, data_ = std::move(stream_).str()]() {
+                const std::string partial_ = file + ".partial";
+                {
+                    std::ofstream out_(partial_, std::ios::binary);
+                    out_.write(data_.data(), std::streamsize(data_.size()));
+                    if(!out_.good()) {
+                        throw esl::exception("could not write checkpoint "
+                                             + partial_);
+                    }
+                }
+                // the previous snapshot is kept until this one is in place
+                if(std::filesystem::exists(file)) {
+                    std::filesystem::rename(file, file + ".previous");
+                }
+                std::filesystem::rename(partial_, file);
+            });
+    }
+
+    simulation::time_point
+    checkpoint::load(simulation::model &simulation, const std::string &file)
+    {
+        std::ifstream in_(file, std::ios::binary);
+        if(!in_.good()) {
+            throw esl::exception("could not open checkpoint " + file);
+        }
+        boost::archive::binary_iarchive archive_(in_);
+        std::string magic_read_;
+        std::uint32_t version_read_ = 0;
+        simulation::time_point time_;
+        archive_ >> magic_read_ >> version_read_ >> time_;
+        if(magic_ != magic_read_ || version_ != version_read_) {
+            throw esl::exception(file + " is not a checkpoint of this version");
+        }
+        archive_ >> simulation.rounds_;
+        archive_ >> simulation.world;
+
+        std::vector<std::shared_ptr<agent>> agents_;
+        std::vector<std::uint8_t> woken_;
+        archive_ >> agents_ >> woken_;
+        simulation.agents.clear_local();
+        simulation.agents.global_agents_.clear();
+        for(size_t i = 0; i < agents_.size(); ++i) {
+            simulation.agents.restore(agents_[i], 0 != woken_[i]);
+        }
+        archive_ >> simulation.agents.global_agents_;
+        simulation.load_state(archive_);
+
+        simulation.time = time_;
+        next_ = time_ + interval;
+        return time_;
+    }
+
+    std::optional<simulation::time_point>
+    checkpoint::peek(const std::string &file)
+    {
+        std::ifstream in_(file, std::ios::binary);
+        if(!in_.good()) {
+            return std::nullopt;
+        }
+        try {
+            boost::archive::binary_iarchive archive_(in_);
+            std::string magic_read_;
+            std::uint32_t version_read_ = 0;
+            simulation::time_point time_;
+            archive_ >> magic_read_ >> version_read_ >> time_;
+            if(magic_ != magic_read_ || version_ != version_read_) {
+                return std::nullopt;
+            }
+            return time_;
+        }catch(const boost::archive::archive_exception &) {
+            return std::nullopt;
+        }
+    }
+
+    void checkpoint::wait()
+    {
+        if(writing_.valid()) {
+            writing_.get();
+        }
+    }
+}  // namespace esl::computation
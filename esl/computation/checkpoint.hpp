@@ -0,0 +1,149 @@
+/// \file   checkpoint.hpp
+///
+/// \brief  Periodic snapshots of a model's state, from which a run resumes.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_COMPUTATION_CHECKPOINT_HPP
+#define ESL_COMPUTATION_CHECKPOINT_HPP
+
+#include <future>
+#include <optional>
+#include <string>
+
+#include <esl/simulation/time.hpp>
+
+
+namespace esl::simulation {
+    class model;
+}
+
+
+namespace esl::computation {
+
+    ///
+    /// \brief  Saves the state of a model to a binary archive at regular
+    ///         intervals, so that a run that was stopped can resume from its
+    ///         latest snapshot.
+    ///
+    /// \details    A snapshot holds the time at which the model resumes, the
+    ///             number of rounds run, the world's identity counter, the
+    ///             local agents with their inboxes, outboxes, outputs and
+    ///             next events, and the state the model adds in
+    ///             `model::save_state`. Agents draw from random streams keyed
+    ///             by the sample, their identity and the time, so a resumed
+    ///             run draws the same numbers.
+    ///
+    ///             The model is serialized on the calling thread, at the end
+    ///             of a time step, so that the snapshot is consistent. The
+    ///             file is written by a background thread while the model
+    ///             continues. A snapshot replaces the previous one only when
+    ///             it is completely written, and the replaced snapshot is
+    ///             kept as `<file>.previous`.
+    ///
+    ///             Agents and messages are saved through pointers to their
+    ///             base class, so their types must be exported using
+    ///             BOOST_CLASS_EXPORT, as when agents migrate between
+    ///             processes.
+    ///
+    class checkpoint
+    {
+    protected:
+        ///
+        /// \brief  The file being written in the background, if any
+        ///
+        std::future<void> writing_;
+
+        ///
+        /// \brief  The time from which the next snapshot is due
+        ///
+        simulation::time_point next_ = 0;
+
+    public:
+        ///
+        /// \brief  The file to save snapshots to and resume from. Empty
+        ///         disables checkpointing.
+        ///
+        std::string path;
+
+        ///
+        /// \brief  The simulated time between snapshots. Zero saves no
+        ///         snapshots, but a run still resumes from an existing one.
+        ///
+        simulation::time_duration interval = 0;
+
+        checkpoint() = default;
+
+        ///
+        /// \brief  Waits until the last snapshot is written.
+        ///
+        ~checkpoint();
+
+        ///
+        /// \return True if a path is set
+        bool enabled() const
+        {
+            return !path.empty();
+        }
+
+        ///
+        /// \brief  Schedules the first snapshot one interval after `time`.
+        ///
+        void start(simulation::time_point time);
+
+        ///
+        /// \return True if a snapshot is due for a model that resumes at
+        ///         `time`
+        bool due(simulation::time_point time) const;
+
+        ///
+        /// \brief  Serializes the model, and starts writing the snapshot to
+        ///         `file` in the background. Waits for the previous snapshot
+        ///         to be written first.
+        ///
+        /// \param time The time at which the model resumes
+        void save( simulation::model &simulation
+                 , simulation::time_point time
+                 , const std::string &file);
+
+        ///
+        /// \brief  Replaces the local agents and the state of the model by
+        ///         those in the snapshot. Does not notify the environment.
+        ///
+        /// \return The time at which the model resumes
+        simulation::time_point load( simulation::model &simulation
+                                   , const std::string &file);
+
+        ///
+        /// \return The time at which the snapshot in `file` resumes, or
+        ///         nothing if there is no complete snapshot
+        static std::optional<simulation::time_point>
+        peek(const std::string &file);
+
+        ///
+        /// \brief  Waits until the last snapshot is written, and rethrows
+        ///         errors from writing it.
+        ///
+        void wait();
+    };
+}  // namespace esl::computation
+
+#endif  // ESL_COMPUTATION_CHECKPOINT_HPP
@@ -25,16 +25,31 @@
 #include <esl/computation/distributed/mpi_environment.hpp>
 
 #ifdef WITH_MPI
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/datatype.hpp>
+#include <boost/mpi/exception.hpp>
+#include <boost/mpi/nonblocking.hpp>
+
 #if BOOST_VERSION >= 106500
 #include <boost/serialization/unordered_map.hpp>
 #endif
 #include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include <esl/agent.hpp>
 #include <esl/computation/timing.hpp>
+#include <esl/data/log.hpp>
+#include <esl/exception.hpp>
 #include <esl/interaction/header.hpp>
+#include <esl/interaction/message_codec.hpp>
 #include <esl/simulation/model.hpp>
 
 ///
@@ -66,12 +81,18 @@ namespace esl::computation::distributed {
     ///             implementation is version 2 or higher and provides an
     ///             initialization function that
     ///
-    mpi_environment::mpi_environment()
-    : environment_(boost::mpi::threading::level::single, true)
+    mpi_environment::mpi_environment(boost::mpi::threading::level level)
+    : environment_(level, true)
     , communicator_()
     , agent_locations_()
+    , main_thread_(std::this_thread::get_id())
     {
-
+        MPI_Comm node_;
+        BOOST_MPI_CHECK_RESULT(MPI_Comm_split_type,
+            (MPI_Comm(communicator_), MPI_COMM_TYPE_SHARED,
+             communicator_.rank(), MPI_INFO_NULL, &node_));
+        node_processes_ = unsigned(boost::mpi::communicator(
+            node_, boost::mpi::comm_take_ownership).size());
     }
 
     void mpi_environment::process_migrations(
@@ -82,15 +103,151 @@ namespace esl::computation::distributed {
         }
     }
 
-    ///
-    /// \brief
-    ///
-    /// \return
-    std::vector<migration> mpi_environment::migrate_agents()
+    std::vector<migration>
+    mpi_environment::migrate_agents(simulation::model &simulation,
+                                    const std::vector<std::int64_t> &loads)
     {
-        return {
+        std::vector<migration> result_;
+        const auto ranks_ = loads.size();
+        const auto rank_  = size_t(communicator_.rank());
+        if(ranks_ < 2) {
+            return result_;
+        }
+
+        double mean_ =
+            std::accumulate(loads.begin(), loads.end(), 0.0) / double(ranks_);
+        if(double(loads[rank_]) <= mean_ * (1.0 + tolerance)) {
+            return result_;
+        }
+
+        double deficit_ = 0.0;
+        for(auto l : loads) {
+            deficit_ += std::max(0.0, mean_ - double(l));
+        }
+        if(deficit_ <= 0.0) {
+            return result_;
+        }
 
+        // the share of this process' surplus that each process receives.
+        // Summed over all overloaded processes, no process is sent more
+        // than its deficit
+        std::vector<double> quota_(ranks_, 0.0);
+        for(size_t r = 0; r < ranks_; ++r) {
+            quota_[r] = (double(loads[rank_]) - mean_)
+                      * std::max(0.0, mean_ - double(loads[r])) / deficit_;
+        }
+
+        struct candidate
+        {
+            double score;
+            agent *migrant;
+            node_identifier target;
         };
+        std::vector<candidate> candidates_;
+        const auto message_cost_ = double(message_cost.count());
+        for(auto *a : simulation.agents.slots()) {
+            if(nullptr == a || a->timing.estimate.count() <= 0) {
+                continue;
+            }
+            const auto cost_ = double(a->timing.estimate.count());
+            auto c = communications_.find(a->identifier);
+            for(size_t r = 0; r < ranks_; ++r) {
+                if(quota_[r] < cost_) {
+                    continue;
+                }
+                // messages that become remote, less those that become local
+                double added_ = 0.0;
+                if(communications_.end() != c && c->second.size() == ranks_) {
+                    added_ = c->second[rank_] - c->second[r];
+                }
+                // moving the agent must save more than it costs to talk to it
+                if(added_ * message_cost_ >= cost_) {
+                    continue;
+                }
+                candidates_.push_back(
+                    {added_ * message_cost_ / cost_, a, node_identifier(r)});
+            }
+        }
+
+        // ties are broken by handle, so that the outcome does not depend on
+        // the order of the sort
+        std::sort(candidates_.begin(), candidates_.end(),
+                  [](const candidate &x, const candidate &y) {
+                      if(x.score != y.score) {
+                          return x.score < y.score;
+                      }
+                      if(x.migrant->handle() != y.migrant->handle()) {
+                          return x.migrant->handle() < y.migrant->handle();
+                      }
+                      return x.target < y.target;
+                  });
+
+        std::unordered_set<agent *> moved_;
+        for(const auto &c : candidates_) {
+            const auto cost_ = double(c.migrant->timing.estimate.count());
+            if(quota_[c.target] < cost_ || moved_.count(c.migrant)) {
+                continue;
+            }
+            quota_[c.target] -= cost_;
+            moved_.insert(c.migrant);
+            result_.push_back(
+                {communicator_.rank(), c.target, c.migrant->identifier});
+        }
+        return result_;
+    }
+
+    std::vector<migration>
+    mpi_environment::partition(simulation::model &simulation)
+    {
+        constexpr int root = 0;
+
+        std::vector<partition_vertex> vertices_;
+        for(auto *a : simulation.agents.slots()) {
+            if(nullptr != a) {
+                vertices_.push_back({a->identifier, communicator_.rank(),
+                                     double(a->timing.estimate.count())});
+            }
+        }
+        std::vector<partition_edge> edges_;
+        for(const auto &[sender, recipients] : message_graph_) {
+            for(const auto &[recipient, messages] : recipients) {
+                edges_.push_back({sender, recipient, messages});
+            }
+        }
+
+        std::vector<std::vector<partition_vertex>> all_vertices_;
+        std::vector<std::vector<partition_edge>> all_edges_;
+        boost::mpi::gather(communicator_, vertices_, all_vertices_, root);
+        boost::mpi::gather(communicator_, edges_, all_edges_, root);
+
+        std::vector<migration> result_;
+        if(root == communicator_.rank()) {
+            vertices_.clear();
+            edges_.clear();
+            for(const auto &v : all_vertices_) {
+                vertices_.insert(vertices_.end(), v.begin(), v.end());
+            }
+            for(const auto &e : all_edges_) {
+                edges_.insert(edges_.end(), e.begin(), e.end());
+            }
+            auto assignment_ = partitioning.partition(vertices_, edges_,
+                                                      communicator_.size());
+            for(size_t i = 0; i < vertices_.size(); ++i) {
+                if(assignment_[i] != vertices_[i].location) {
+                    result_.push_back({vertices_[i].location, assignment_[i],
+                                       vertices_[i].vertex});
+                }
+            }
+        }
+        boost::mpi::broadcast(communicator_, result_, root);
+
+        // each process proposes the migrations of its own agents
+        result_.erase(std::remove_if(result_.begin(), result_.end(),
+                                     [this](const migration &m) {
+                                         return m.source != communicator_.rank();
+                                     }),
+                      result_.end());
+        return result_;
     }
 
     size_t mpi_environment::activate()
@@ -128,19 +285,25 @@ namespace esl::computation::distributed {
 
     size_t mpi_environment::deactivate()
     {
-        auto result_ = deactivated_.size();
-        std::vector<deactivation> deactivated_locally_(deactivated_.size());
-        for(size_t i = 0; i < deactivated_.size(); ++i) {
-            deactivated_locally_[i] = {deactivated_[i]};
+        std::vector<deactivation> deactivated_locally_;
+        deactivated_locally_.reserve(deactivated_.size());
+        for(const auto &i : deactivated_) {
+            deactivated_locally_.push_back({i});
         }
 
-        std::vector<deactivation> deactivations_;
-        boost::mpi::all_to_all(communicator_, deactivated_locally_,
+        std::vector<std::vector<deactivation>> deactivations_;
+        boost::mpi::all_gather(communicator_, deactivated_locally_,
                                deactivations_);
 
-        for(const auto &a : deactivations_) {
-            deactivate_agent(a.deactivated);
+        // local agents were already removed in deactivate_agent
+        size_t result_ = 0;
+        for(const auto &process_ : deactivations_) {
+            for(const auto &d : process_) {
+                agent_locations_.erase(d.deactivated);
+                ++result_;
+            }
         }
+        deactivated_.clear();
         return result_;
     }
 
@@ -150,9 +313,6 @@ namespace esl::computation::distributed {
     void mpi_environment::migrate(simulation::model &simulation,
                                   agent_timing &timing)
     {
-        (void)timing;  // TODO: re-implemnt timings
-
-
         constexpr int root =
             0;  // TODO: get confirmation this is up to MPI spec
 
@@ -165,96 +325,19 @@ namespace esl::computation::distributed {
                 }
             } else {
             }
-        } else {
-            auto idea_ = migrate_agents();
-            for(const auto &m : idea_) {
+        } else if(0 < partition_interval
+                  && (1 == steps_ || 0 == steps_ % partition_interval)) {
+            for(const auto &m : partition(simulation)) {
+                proposed_[m.target].push_back(m);
+            }
+        } else if(load_balancing) {
+            std::vector<std::int64_t> loads_;
+            boost::mpi::all_gather(communicator_,
+                                   std::int64_t(timing.estimate.count()),
+                                   loads_);
+            for(const auto &m : migrate_agents(simulation, loads_)) {
                 proposed_[m.target].push_back(m);
             }
-
-            /*
-            std::vector<::esl::computation::agent_timing> timings_;
-            boost::mpi::all_gather<esl::computation::agent_timing>(
-                communicator_, timing, timings_);
-            auto mean_agent_act_time_ =
-                accumulate(
-                    timings_.begin(), timings_.end(), 0.0,
-                    [](double a, const ::esl::computation::agent_timing &b) {
-                        return a + b.acting.count();
-                    })
-                / communicator_.size();
-
-
-            if(mean_agent_act_time_ * 1.0 < timing.acting.count()) {
-                // log() << "did " << (timing.agent_computation / 1000000) <<
-                // "ms, other processes took on average " <<
-                // double(mean_agent_act_time_ / 1000000) << "ms" << endl;
-                auto budget_ = std::min<double>(0.1 * timing.acting.count(),
-                                                timing.acting.count()
-                                                    - mean_agent_act_time_);
-
-                std::set<node_identifier> offload_;
-                for(node_identifier n = 0; n < communicator_.size(); ++n) {
-                    if(communicator_.rank() == n) {
-                        continue;
-                    }
-                    if(mean_agent_act_time_ > timings_[n].acting.count()) {
-                        offload_.insert(n);
-                    }
-                }
-
-                // by property of the mean computation time this is must be true
-                // if there are two or more nodes in the cluster
-                if(!offload_.empty()) {
-                    // log() << " offload_.size() " << offload_.size() << endl;
-                    size_t offloaded_ = 0;
-                    for(auto &a : simulation.agents.local_agents_) {
-                        if(budget_ < 0.0) {
-                            break;
-                        }
-                        std::vector<std::tuple<node_identifier, long double>>
-                            communication_costs_;
-                        // for(const auto &candidate_ :
-                        // communications_[a.first]){
-                        //    communication_costs_.push_back({candidate_.first,
-                        //    candidate_.second.value()});
-                        //}
-                        std::sort(
-                            communication_costs_.begin(),
-                            communication_costs_.end(),
-                            [](const std::tuple<node_identifier, long double>
-                                   &first,
-                               const std::tuple<node_identifier, long double>
-                                   &second) -> bool {
-                                return std::get<1>(first) > std::get<1>(second);
-                            });
-                        for(auto candidate_ : communication_costs_) {
-                            if(communicator_.rank() == get<0>(candidate_)) {
-                                continue;
-                            }
-                            if(offload_.find(get<0>(candidate_))
-                               != offload_.end()) {
-                                ++offloaded_;
-                                // log() << "offloaded agent with mean compute
-                                // time " <<
-                                // (agent_action_time_[a->identifier].value() /
-                                // 1000000) << "ms" << endl;
-                                proposed_[get<0>(candidate_)].push_back(
-                                    {communicator_.rank(), get<0>(candidate_),
-                                     a.first});
-                                // budget_ -=
-                                // agent_action_time_[a.first].value(); log() <<
-                                // "wants to move agent " << a->identifier << "
-                                // to node " << get<0>(candidate_) << ", one of
-                                // "
-                                // << offload_.size() << " node candidates" <<
-                                // endl;
-                                break;
-                            }
-                        }
-                    }
-                    // log() << "offloaded " << offloaded_ << endl;
-                }
-            }*/
         }
 
         // propositions are peer to peer
@@ -285,31 +368,23 @@ namespace esl::computation::distributed {
         }
         process_migrations(result1_);
 
-        std::cout << communicator_.rank() << " execute migrations" << std::endl;
-
         for(const auto &m : result1_) {
             if(m.source == communicator_.rank()) {
                 // log() << "sending agent to " << m.target << endl;
-                // TODO: inefficient
-                for(const auto &a : simulation.agents.local_agents_) {
-                    if(a.first == m.migrant) {
-                        std::shared_ptr<agent> astd = a.second;
-                        boost::shared_ptr<agent> a2 = to_boost_ptr<esl::agent>(astd);
-                        communicator_.send(m.target, 0, a2);
-                        simulation.agents.local_agents_.erase(a.first);
-                        break;
-                    }
+                auto iterator_ = simulation.agents.local_agents_.find(m.migrant);
+                if(simulation.agents.local_agents_.end() != iterator_) {
+                    std::shared_ptr<agent> astd = iterator_->second;
+                    boost::shared_ptr<agent> a2 = to_boost_ptr<esl::agent>(astd);
+                    communicator_.send(m.target, 0, a2);
+                    simulation.agents.erase_local(m.migrant);
+                    communications_.erase(m.migrant);
+                    message_graph_.erase(m.migrant);
                 }
             } else if(m.target == communicator_.rank()) {
                 // log() << "receiving agent from " << m.source << endl;
                 boost::shared_ptr<agent> migrant_;
                 communicator_.recv(m.source, 0, migrant_);
-                simulation.agents.local_agents_.insert(
-                    {migrant_->identifier, to_std_ptr(migrant_)});
-                for(node_identifier n = 0; n < communicator_.size(); ++n) {
-                    // communications_[migrant_->identifier].insert({n,
-                    // timer<mean>()});
-                }
+                simulation.agents.insert_local(to_std_ptr(migrant_));
 
                 if(simulation.time >= simulation.end) {
                     // write agent outputs to disk
@@ -320,56 +395,343 @@ namespace esl::computation::distributed {
     }
 
 
+    void mpi_environment::dispatch_remote(agent &a)
+    {
+        const auto ranks_ = size_t(communicator_.size());
+        if(remote_.size() != ranks_) {
+            remote_.resize(ranks_);
+            incoming_.resize(ranks_);
+        }
+        if(a.outbox.empty()) {
+            return;
+        }
+
+        // remote edges are added to the graph directly, as their recipients
+        // have no local handle
+        auto *edges_ = 0 < partition_interval
+                     ? &message_graph_[a.identifier] : nullptr;
+        // local messages stay in the outbox, in order, until the end of the
+        // round
+        size_t kept_ = 0;
+        for(size_t i = 0; i < a.outbox.size(); ++i) {
+            auto &m = a.outbox[i];
+            auto location_ = agent_locations_.find(m->recipient);
+            if(agent_locations_.end() == location_) {
+                throw esl::exception("message recipient agent not found "
+                                     + m->recipient.representation());
+            }
+            if(communicator_.rank() == location_->second) {
+                a.outbox[kept_++] = std::move(m);
+                continue;
+            }
+            if(windowed_ && m->received < horizon_) {
+                throw esl::exception("message to another process is received "
+                                     "before the end of the window, its delay "
+                                     "is shorter than the lookahead");
+            }
+            if(edges_) {
+                (*edges_)[m->recipient] += 1.0;
+            }
+            if(load_balancing) {
+                count_message(a.handle(), location_->second);
+            }
+            auto &remote_messages_ = remote_[location_->second];
+            remote_messages_.push_back(std::move(m));
+            if(message_chunk <= remote_messages_.size()) {
+                send_chunk(location_->second, message_tag);
+            }
+        }
+        a.outbox.resize(kept_);
+    }
+
+    void mpi_environment::send_chunk(node_identifier process, int tag)
+    {
+        chunks_.emplace_back();
+        interaction::message_codec::encode(remote_[process], chunks_.back());
+        remote_[process].clear();
+        requests_.push_back(communicator_.isend(
+            process, tag, chunks_.back().data(), int(chunks_.back().size())));
+    }
+
+    void mpi_environment::agent_finished(agent &a)
+    {
+        if(std::this_thread::get_id() == main_thread_) {
+            dispatch_remote(a);
+            return;
+        }
+        std::lock_guard lock_(finished_mutex_);
+        finished_.push_back(&a);
+    }
+
+    bool mpi_environment::progress()
+    {
+        std::vector<agent *> finished_now_;
+        std::vector<activation_change> changes_now_;
+        {
+            std::lock_guard lock_(finished_mutex_);
+            finished_now_.swap(finished_);
+            changes_now_.swap(changes_);
+        }
+        // an agent's changes precede it finishing, so its recipients created
+        // in the same round are known when its messages are dispatched
+        for(const auto &c : changes_now_) {
+            apply_change(c.changed, c.activated);
+        }
+        for(auto *a : finished_now_) {
+            dispatch_remote(*a);
+        }
+        return !finished_now_.empty();
+    }
+
+    unsigned int mpi_environment::hardware_threads() const
+    {
+        return std::max(1u, environment::hardware_threads() / node_processes_);
+    }
+
     ///
     /// Send and receive messages, to all nodes all at the same time
     ///
+    /// \details    Messages to agents on other processes are encoded with the
+    ///             `interaction::message_codec` and sent point-to-point, in
+    ///             chunks of `message_chunk` messages. When the model runs
+    ///             agents sequentially, chunks are sent while the remaining
+    ///             agents compute (see `agent_finished`). At the end of the
+    ///             round, every process sends a last, possibly empty, chunk
+    ///             to every other process, delivers local messages while
+    ///             these are in transit, and then receives until it has the
+    ///             last chunk of every process.
+    ///
     size_t mpi_environment::send_messages(simulation::model &simulation)
     {
-        std::vector<std::vector<interaction::header>> messages_;
-        std::vector<std::vector<interaction::header>> messages_sent_(
-            communicator_.size());
+        const auto ranks_ = size_t(communicator_.size());
+        remote_.resize(ranks_);
+        incoming_.resize(ranks_);
+
+        if(1 < simulation.threads
+           && environment_.thread_level() < boost::mpi::threading::funneled) {
+            throw esl::exception("models with threads need MPI thread "
+                                 "support of at least funneled");
+        }
+        // all senders are dispatched below
+        finished_.clear();
+        apply_changes();
+
+        senders_.clear();
+        if(simulation::model::by_event == simulation.activation) {
+            senders_.assign(simulation.scheduled_agents().begin(),
+                            simulation.scheduled_agents().end());
+        }else{
+            for(auto *a : simulation.agents.slots()) {
+                if(nullptr != a) {
+                    senders_.push_back(a);
+                }
+            }
+        }
 
-        for(const auto &[i, a] : simulation.agents.local_agents_) {
-            (void) i;
-            for(const auto &m : a->outbox) {
-                auto target_ = agent_locations_[m->recipient];
-                if(communicator_.rank() == target_) {
-                    simulation.agents.local_agents_.find(m->recipient)
-                        ->second->inbox.insert({m->received, m});
-                    std::cout << "same process fastpath" << std::endl;
-                } else {
-                    messages_sent_[target_].push_back(interaction::header(*m));
-                    std::cout << "other process delivery" << std::endl;
+        for(auto *a : senders_) {
+            dispatch_remote(*a);
+        }
+        // within a window, other processes are not waiting for messages
+        if(!windowed_) {
+            send_last_chunks();
+        }
+
+        // local messages are delivered while the last chunks are in transit.
+        // Their senders and recipients are recorded by handle, and counted
+        // once per round in merge_communication
+        record_deliveries_ = measures_communication();
+        size_t messages_ = 0;
+        if(1 < simulation.threads) {
+            messages_ += send_messages_parallel(simulation);
+        }else{
+            if(record_deliveries_ && delivered_.empty()) {
+                delivered_.resize(1);
+            }
+            for(auto *a : senders_) {
+                for(auto &m : a->outbox) {
+                    auto &recipient_ = deliver(simulation, std::move(m));
+                    if(record_deliveries_) {
+                        delivered_[0].emplace_back(a->handle(),
+                                                   recipient_.handle());
+                    }
+                    ++messages_;
                 }
+                a->outbox.clear();
+            }
+            if(record_deliveries_) {
+                std::sort(delivered_[0].begin(), delivered_[0].end());
             }
-            a->outbox.clear();
         }
 
-        boost::mpi::all_to_all(communicator_, messages_sent_, messages_);
-        for(node_identifier i = 0; i < node_identifier(messages_.size()); ++i) {
-            if(messages_[i].empty()) {
+        if(!windowed_) {
+            messages_ += receive_remote(simulation);
+        }
+        merge_communication(simulation);
+        return messages_;
+    }
+
+    void mpi_environment::send_last_chunks()
+    {
+        for(node_identifier r = 0; r < communicator_.size(); ++r) {
+            if(r != communicator_.rank()) {
+                send_chunk(r, last_tag);
+            }
+        }
+    }
+
+    size_t mpi_environment::receive_remote(simulation::model &simulation)
+    {
+        const auto ranks_ = size_t(communicator_.size());
+        const auto rank_  = size_t(communicator_.rank());
+
+        // chunks from one process arrive in the order they were sent
+        for(size_t r = 0; r < ranks_; ++r) {
+            incoming_[r].clear();
+            if(r == rank_) {
                 continue;
             }
-            for(auto &m : messages_[i]) {
-                (void) m;
-                if(i == communicator_.rank()) {
-                    for(node_identifier j = 0;
-                        node_identifier(messages_sent_.size());
-                        ++j) {
-                        for(const auto &message_ : messages_sent_[j]) {
-                            communicator_.send<interaction::header>(j, 0,
-                                                                    message_);
-                        }
+            int tag_;
+            do {
+                auto status_ = communicator_.probe(int(r), boost::mpi::any_tag);
+                tag_ = status_.tag();
+                incoming_[r].emplace_back(size_t(*status_.count<char>()));
+                communicator_.recv(int(r), tag_, incoming_[r].back().data(),
+                                   int(incoming_[r].back().size()));
+            } while(last_tag != tag_);
+        }
+        boost::mpi::wait_all(requests_.begin(), requests_.end());
+        requests_.clear();
+        chunks_.clear();
+
+        // deliver in order of the sending process, so that inboxes do not
+        // depend on the order in which chunks arrived
+        size_t messages_ = 0;
+        earliest_received_ = std::numeric_limits<simulation::time_point>::max();
+        for(size_t r = 0; r < ranks_; ++r) {
+            for(const auto &chunk_ : incoming_[r]) {
+                if(!chunk_.empty()) {
+                    interaction::message_codec::decode(
+                        chunk_.data(), chunk_.size(),
+                        [&](std::shared_ptr<interaction::header> m) {
+                            earliest_received_ =
+                                std::min(earliest_received_, m->received);
+                            auto &recipient_ =
+                                deliver(simulation, std::move(m));
+                            if(load_balancing) {
+                                count_message(recipient_.handle(), r);
+                            }
+                            ++messages_;
+                        });
+                }
+            }
+        }
+        return messages_;
+    }
+
+    bool mpi_environment::measures_communication() const
+    {
+        return load_balancing || 0 < partition_interval;
+    }
+
+    void mpi_environment::count_message(simulation::agent_handle local,
+                                        size_t process, double messages)
+    {
+        if(simulation::invalid_handle == local) {
+            return;
+        }
+        const auto ranks_ = size_t(communicator_.size());
+        const auto index_ = size_t(local) * ranks_ + process;
+        if(round_communications_.size() <= index_) {
+            round_communications_.resize((size_t(local) + 1) * ranks_, 0.0);
+        }
+        round_communications_[index_] += messages;
+    }
+
+    ///
+    /// \details    The recorded local messages are sorted by sender and
+    ///             recipient, so that the message graph is updated once per
+    ///             sender and edge, rather than once per message.
+    ///
+    void mpi_environment::merge_communication(simulation::model &simulation)
+    {
+        const auto ranks_ = size_t(communicator_.size());
+        const auto rank_  = size_t(communicator_.rank());
+
+        for(auto &worker_ : delivered_) {
+            std::unordered_map<identity<agent>, double> *edges_ = nullptr;
+            auto edges_sender_ = simulation::invalid_handle;
+            for(size_t i = 0; i < worker_.size();) {
+                auto [sender_, recipient_] = worker_[i];
+                size_t j = i + 1;
+                while(j < worker_.size() && worker_[j] == worker_[i]) {
+                    ++j;
+                }
+                const auto messages_ = double(j - i);
+                if(load_balancing) {
+                    count_message(sender_, rank_, messages_);
+                    count_message(recipient_, rank_, messages_);
+                }
+                auto *from_ = simulation.agents.get(sender_);
+                auto *to_   = simulation.agents.get(recipient_);
+                if(0 < partition_interval && from_ && to_) {
+                    if(edges_sender_ != sender_) {
+                        edges_ = &message_graph_[from_->identifier];
+                        edges_sender_ = sender_;
                     }
+                    (*edges_)[to_->identifier] += messages_;
+                }
+                i = j;
+            }
+            worker_.clear();
+        }
 
-                } else if(i == communicator_.rank()) {
-                    // std::shared_ptr<interaction::header> message_;
-                    // communicator_.recv(i, 0, message_);
+        for(size_t h = 0; h * ranks_ < round_communications_.size(); ++h) {
+            auto *counts_ = &round_communications_[h * ranks_];
+            if(std::all_of(counts_, counts_ + ranks_,
+                           [](double c) { return 0.0 == c; })) {
+                continue;
+            }
+            if(auto *a = simulation.agents.get(simulation::agent_handle(h))) {
+                auto &exchanged_ = communications_[a->identifier];
+                exchanged_.resize(ranks_, 0.0);
+                for(size_t r = 0; r < ranks_; ++r) {
+                    exchanged_[r] += counts_[r];
                 }
             }
+            std::fill(counts_, counts_ + ranks_, 0.0);
+        }
+    }
+
+    agent &mpi_environment::deliver(simulation::model &simulation,
+                                    std::shared_ptr<interaction::header> m)
+    {
+        auto *recipient_ = simulation.agents.find(m->recipient);
+        if(nullptr == recipient_) {
+            throw esl::exception("message recipient agent not found "
+                                 + m->recipient.representation());
+        }
+        recipient_->inbox.insert({m->received, std::move(m)});
+        if(simulation.agents.event_driven) {
+            simulation.agents.wake(recipient_);
+        }
+        return *recipient_;
+    }
+
+    simulation::time_point
+    mpi_environment::first_event(simulation::time_point first_event)
+    {
+        if(windowed_) {
+            return first_event;
         }
+        simulation::time_point result_ = first_event;
+        boost::mpi::all_reduce(communicator_, first_event, result_,
+                               boost::mpi::minimum<simulation::time_point>());
+        return result_;
+    }
 
-        return 0;
+    bool mpi_environment::measures_agents() const
+    {
+        return true;
     }
 
     ///
@@ -377,20 +739,22 @@ namespace esl::computation::distributed {
     void
     mpi_environment::clear_agents(std::shared_ptr<simulation::model> simulation)
     {
-        simulation->agents.local_agents_.clear();
+        simulation->agents.clear_local();
         agent_locations_.clear();
+        communications_.clear();
+        message_graph_.clear();
     }
 
     ///
     /// \param a
     void mpi_environment::activate_agent(const identity<agent> &a)
     {
-        agent_locations_[a] = static_cast<unsigned int>(communicator_.rank());
-
-        activated_.push_back(a);
-        for(node_identifier n = 0; n < communicator_.size(); ++n) {
-            // communications_[a].insert({n, timer<mean>()});
+        if(std::this_thread::get_id() != main_thread_) {
+            std::lock_guard lock_(finished_mutex_);
+            changes_.push_back({a, true});
+            return;
         }
+        apply_change(a, true);
     }
 
     ///
@@ -407,11 +771,41 @@ namespace esl::computation::distributed {
     /// \param a
     void mpi_environment::deactivate_agent(const identity<agent> &a)
     {
+        if(std::this_thread::get_id() != main_thread_) {
+            std::lock_guard lock_(finished_mutex_);
+            changes_.push_back({a, false});
+            return;
+        }
+        apply_change(a, false);
+    }
+
+    void mpi_environment::apply_change(const identity<agent> &a,
+                                       bool activated)
+    {
+        if(activated) {
+            agent_locations_[a] =
+                static_cast<unsigned int>(communicator_.rank());
+            activated_.push_back(a);
+            return;
+        }
         agent_locations_.erase(a);
-        // agent_action_time_.erase(a);
+        communications_.erase(a);
+        message_graph_.erase(a);
         deactivated_.push_back(a);
     }
 
+    void mpi_environment::apply_changes()
+    {
+        std::vector<activation_change> changes_now_;
+        {
+            std::lock_guard lock_(finished_mutex_);
+            changes_now_.swap(changes_);
+        }
+        for(const auto &c : changes_now_) {
+            apply_change(c.changed, c.activated);
+        }
+    }
+
 
     void mpi_environment::before_step()
     {
@@ -420,9 +814,45 @@ namespace esl::computation::distributed {
 
     void mpi_environment::after_step(simulation::model &simulation)
     {
+        // within a window, processes take different numbers of steps
+        if(!windowed_) {
+            rebalance(simulation);
+        }
+    }
+
+    void mpi_environment::rebalance(simulation::model &simulation)
+    {
+        // the load of this process is the sum of its agents' estimates
         agent_timing timing_;
+        for(auto *a : simulation.agents.slots()) {
+            if(nullptr != a) {
+                timing_.messaging += a->timing.messaging;
+                timing_.acting    += a->timing.acting;
+                timing_.estimate  += a->timing.estimate;
+            }
+        }
+        ++steps_;
         migrate(simulation, timing_);
-        std::cout << "after_step()" << std::endl;
+
+        // older communication counts weigh less
+        for(auto &[i, c] : communications_) {
+            (void)i;
+            for(auto &n : c) {
+                n /= 2;
+            }
+        }
+        // edges that are no longer used are forgotten
+        for(auto &[i, recipients] : message_graph_) {
+            (void)i;
+            for(auto r = recipients.begin(); r != recipients.end();) {
+                r->second /= 2;
+                if(r->second < 1.0 / 64) {
+                    r = recipients.erase(r);
+                }else{
+                    ++r;
+                }
+            }
+        }
     }
 
     ///
@@ -432,93 +862,180 @@ namespace esl::computation::distributed {
         return communicator_.rank() == 0;
     }
 
+    ///
+    /// \details    The step's per-round reductions already make all processes
+    ///             agree on the next event, so the bounds of the next step
+    ///             are combined in a single non-blocking reduction, during
+    ///             which the agents created and removed in the step are
+    ///             announced to the other processes.
     ///
     /// \param simulation
     void mpi_environment::run(simulation::model &simulation)
     {
-        // timer<mean> timer_initialisation_;
-        // timer_initialisation_.start();
         simulation.initialize();
-        // timer_initialisation_.stop();
-        // log() << "initialisation " << timer_initialisation_.value() /
-        // std::chrono::high_resolution_clock::period::den << "s" << endl;
 
-        // timer<mean> timer_run_;
-        // timer_run_.start();
-        // timer<mean> communication_pre_;
-        simulation::time_point next_timestep_minimum_ = simulation.time;
+        simulation::time_interval step_ = {restore(simulation), simulation.end};
+        activate();
+        deactivate();
 
-        simulation::time_interval timestep_ = {next_timestep_minimum_,
-                                               simulation.end};
+        if(0 < lookahead) {
+            run_windows(simulation, step_);
+            return;
+        }
 
-        while(timestep_.lower < simulation.end) {
-            timestep_.lower = simulation.step(timestep_);
-            // we need a temporary value so that the input and output memory
-            // addresses don't overlap
-            {
-                simulation::time_point lower_;
-                boost::mpi::reduce(
-                    communicator_, timestep_.lower, lower_,
-                    boost::mpi::minimum<simulation::time_point>(), 0);
-                boost::mpi::broadcast(communicator_, lower_, 0);
-                timestep_.lower = lower_;
-                simulation::time_point upper_;
-                boost::mpi::reduce(
-                    communicator_, timestep_.upper, upper_,
-                    boost::mpi::minimum<simulation::time_point>(), 0);
-                boost::mpi::broadcast(communicator_, upper_, 0);
-                timestep_.upper = upper_;
-            };
-
-            if(timestep_.lower >= simulation.end) {
-                break;
+        while(step_.lower < simulation.end) {
+            if(is_coordinator()) {
+                std::cout << "----------- round " << step_ << "-----------"
+                          << std::endl;
             }
 
+            step_.lower = simulation.step(step_);
+
+            // separate buffers, so that the input and output memory
+            // addresses don't overlap
+            simulation::time_point local_[2] = {step_.lower, step_.upper};
+            simulation::time_point global_[2];
+            MPI_Request request_;
+            BOOST_MPI_CHECK_RESULT(MPI_Iallreduce,
+                (local_, global_, 2,
+                 boost::mpi::get_mpi_datatype<simulation::time_point>(),
+                 MPI_MIN, MPI_Comm(communicator_), &request_));
+
+            activate();
+            deactivate();
+
+            BOOST_MPI_CHECK_RESULT(MPI_Wait, (&request_, MPI_STATUS_IGNORE));
+            step_ = {global_[0], global_[1]};
+            save_checkpoint(simulation, step_.lower);
+        }
+        checkpoints.wait();
+    }
+
+    ///
+    /// \details    Each process steps through its own events until the
+    ///             horizon, which is `lookahead` past the start of the
+    ///             window, without waiting for the others. Messages to other
+    ///             processes are received at or after the horizon, so they
+    ///             are exchanged only at the end of the window, after which
+    ///             the next window starts at the earliest pending event.
+    ///
+    void mpi_environment::run_windows(simulation::model &simulation,
+                                      simulation::time_interval step)
+    {
+        while(step.lower < simulation.end) {
             if(is_coordinator()) {
-                std::cout << "----------- round " << timestep_ << "-----------"
-                          << std::endl;
+                LOG(trace) << "window " << step << std::endl;
             }
 
-            next_timestep_minimum_ =
-                simulation.time;  // by default, we progress to the end of the
-                                   // current interval
-
-            // communication_pre_.start();
-            agent_timing timing_;
-
-            size_t changes_ = 0;
-            changes_ += activate();
-            changes_ += deactivate();
-            if(changes_) {
-                // log() << "now has " << simulation.agents.agents_.size() << "
-                // agents " << std::endl;
-            }
-
-            ////////////////////////////////////////////////////////////////////
-            // report agent totals
-            ////////////////////////////////////////////////////////////////////
-            uint64_t agents_ = 0;
-            {
-                std::vector<uint64_t> agent_counts_;
-                boost::mpi::all_gather(communicator_,
-                                       simulation.agents.local_agents_.size(),
-                                       agent_counts_);
-                for(const auto &c : agent_counts_) {
-                    agents_ += c;
+            horizon_ = std::min(simulation.end, step.lower + lookahead);
+            auto next_ = step.lower;
+            windowed_ = true;
+            while(next_ < horizon_) {
+                next_ = simulation.step({next_, simulation.end});
+            }
+            windowed_ = false;
+
+            send_last_chunks();
+            receive_remote(simulation);
+            merge_communication(simulation);
+            rebalance(simulation);
+
+            simulation::time_point local_[2] = {
+                std::min(next_, earliest_received_), step.upper};
+            simulation::time_point global_[2];
+            MPI_Request request_;
+            BOOST_MPI_CHECK_RESULT(MPI_Iallreduce,
+                (local_, global_, 2,
+                 boost::mpi::get_mpi_datatype<simulation::time_point>(),
+                 MPI_MIN, MPI_Comm(communicator_), &request_));
+
+            activate();
+            deactivate();
+
+            BOOST_MPI_CHECK_RESULT(MPI_Wait, (&request_, MPI_STATUS_IGNORE));
+            step = {global_[0], global_[1]};
+            save_checkpoint(simulation, step.lower);
+        }
+        checkpoints.wait();
+    }
+
+    std::string mpi_environment::checkpoint_file() const
+    {
+        return checkpoints.path + "." + std::to_string(communicator_.rank());
+    }
+
+    ///
+    /// \details    Processes may have been stopped while some of them were
+    ///             still writing their latest snapshot, so all processes
+    ///             resume from the latest snapshot that all of them
+    ///             completed.
+    ///
+    simulation::time_point
+    mpi_environment::restore(simulation::model &simulation)
+    {
+        const auto file_ = checkpoint_file();
+        const std::string files_[2] = {file_, file_ + ".previous"};
+        std::vector<simulation::time_point> local_;
+        if(checkpoints.enabled()) {
+            for(const auto &f : files_) {
+                if(auto time_ = checkpoint::peek(f)) {
+                    local_.push_back(*time_);
                 }
             }
-            ////////////////////////////////////////////////////////////////////
-            std::unordered_map<std::shared_ptr<agent>, bool> agent_done_;
-            for(auto a : simulation.agents.local_agents_) {
-                // agent_done_[a] = false;
+        }
+        std::vector<std::vector<simulation::time_point>> snapshots_;
+        boost::mpi::all_gather(communicator_, local_, snapshots_);
+
+        std::optional<simulation::time_point> common_;
+        bool any_ = false;
+        for(auto t : snapshots_[0]) {
+            bool everywhere_ = true;
+            for(const auto &s : snapshots_) {
+                everywhere_ = everywhere_
+                           && s.end() != std::find(s.begin(), s.end(), t);
+            }
+            if(everywhere_ && (!common_ || *common_ < t)) {
+                common_ = t;
             }
-
-            simulation.step(timestep_);
         }
+        for(const auto &s : snapshots_) {
+            any_ = any_ || !s.empty();
+        }
+        if(!common_) {
+            if(any_) {
+                throw esl::exception("the processes have no checkpoint in "
+                                     "common, was the number of processes "
+                                     "changed?");
+            }
+            checkpoints.start(simulation.start);
+            return simulation.start;
+        }
+
+        auto time_ = checkpoints.load(simulation,
+            checkpoint::peek(files_[0]) == common_ ? files_[0] : files_[1]);
+        activated_.clear();
+        deactivated_.clear();
 
-        // timer_run_.stop();
-        // log() << "computation " << timer_run_.value()  /
-        // std::chrono::high_resolution_clock::period::den << "s" << endl;
+        // the agents are where they were when the snapshots were saved
+        std::vector<identity<agent>> restored_;
+        for(auto *a : simulation.agents.slots()) {
+            if(nullptr != a) {
+                restored_.push_back(a->identifier);
+            }
+        }
+        std::vector<std::vector<identity<agent>>> locations_;
+        boost::mpi::all_gather(communicator_, restored_, locations_);
+        agent_locations_.clear();
+        for(size_t r = 0; r < locations_.size(); ++r) {
+            for(const auto &i : locations_[r]) {
+                agent_locations_[i] = node_identifier(r);
+            }
+        }
+        if(is_coordinator()) {
+            LOG(notice) << "resuming from checkpoint at time " << time_
+                        << std::endl;
+        }
+        return time_;
     }
 }  // namespace esl::computation::distributed
 
@@ -29,10 +29,20 @@
 
 #include <boost/mpi/communicator.hpp>
 #include <boost/mpi/environment.hpp>
+#include <boost/mpi/request.hpp>
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <esl/agent.hpp>
+#include <esl/computation/distributed/partitioner.hpp>
 #include <esl/computation/distributed/protocol.hpp>
 #include <esl/computation/environment.hpp>
 #include <esl/simulation/identity.hpp>
@@ -46,6 +56,14 @@ namespace esl::computation::distributed {
     ///
     /// \brief  Environment that uses MPI to accelerate message passing.
     ///
+    /// \details    Models can combine processes with threads: for example one
+    ///             process per socket or NUMA node, set at launch with
+    ///             `mpirun --map-by ppr:1:socket --bind-to socket`, and a
+    ///             thread pool in each process through the model's `threads`
+    ///             parameter. Only the thread that runs the model calls MPI.
+    ///             While workers run agents, it sends the messages of the
+    ///             agents that finished.
+    ///
     class mpi_environment
     : public environment
     {
@@ -67,16 +85,199 @@ namespace esl::computation::distributed {
             agent_locations_;
 
         ///
-        /// \brief  In MPI distributed mode, the communication times are
-        ///         important when computational environment is not uniform.
+        /// \brief  MPI tag of chunks of messages. Tag 0 is used to migrate
+        ///         agents.
+        ///
+        constexpr static int message_tag = 1;
+
+        ///
+        /// \brief  MPI tag of the last chunk of messages that a process
+        ///         sends to another in a round.
+        ///
+        constexpr static int last_tag = 2;
+
+        ///
+        /// \brief  Messages to agents on other processes that are not yet
+        ///         sent, by process. Reused between steps.
+        ///
+        std::vector<std::vector<std::shared_ptr<interaction::header>>> remote_;
+
+        ///
+        /// \brief  Encoded chunks that are being sent. A deque, so that
+        ///         buffers in transit do not move.
+        ///
+        std::deque<std::string> chunks_;
+
+        ///
+        /// \brief  Requests of the chunks that are being sent.
+        ///
+        std::vector<boost::mpi::request> requests_;
+
+        ///
+        /// \brief  Encoded chunks received in the current round, by source
+        ///         process
+        ///
+        std::vector<std::vector<std::vector<char>>> incoming_;
+
+        ///
+        /// \brief  The thread that constructed the environment, which is the
+        ///         only thread that calls MPI.
+        ///
+        std::thread::id main_thread_;
+
+        ///
+        /// \brief  Agents that finished on worker threads, whose messages
+        ///         are yet to be dispatched by the main thread.
+        ///
+        std::vector<agent *> finished_;
+
+        ///
+        /// \brief  An agent activated (`true`) or deactivated (`false`) on
+        ///         a worker thread
+        ///
+        struct activation_change
+        {
+            identity<agent> changed;
+            bool activated;
+        };
+
+        ///
+        /// \brief  Activations and deactivations on worker threads, in the
+        ///         order they happened. These are applied by the main
+        ///         thread, which owns `agent_locations_`, `communications_`
+        ///         and `message_graph_`.
+        ///
+        std::vector<activation_change> changes_;
+
+        ///
+        /// \brief  Guards `finished_` and `changes_`
+        ///
+        std::mutex finished_mutex_;
+
+        ///
+        /// \brief  The number of processes on this process' node.
         ///
-        // std::unordered_map<identity<agent>,
-        // std::unordered_map<node_identifier, timer<mean> >> communications_;
+        unsigned int node_processes_ = 1;
+
+        ///
+        /// \brief  For each local agent, the number of messages it exchanged
+        ///         with agents on each process, halved after every step.
+        ///         Used to keep agents close to the agents they talk to.
+        ///
+        std::unordered_map<identity<agent>, std::vector<double>>
+            communications_;
+
+        ///
+        /// \brief  For each local agent, the number of messages it sent to
+        ///         each other agent, halved after every step. The edges of
+        ///         the communication graph used by the partitioner.
+        ///
+        std::unordered_map<identity<agent>,
+                           std::unordered_map<identity<agent>, double>>
+            message_graph_;
+
+        ///
+        /// \brief  The messages that each local agent exchanged with each
+        ///         process in the current round, indexed by handle times
+        ///         the number of processes plus the process. Merged into
+        ///         `communications_` once per round.
+        ///
+        std::vector<double> round_communications_;
+
+        ///
+        /// \brief  Steps completed by this environment.
+        ///
+        std::uint64_t steps_ = 0;
+
+        ///
+        /// \brief  True while the process advances through a window on its
+        ///         own, when messages to other processes are held back and
+        ///         no collective operations are performed.
+        ///
+        bool windowed_ = false;
+
+        ///
+        /// \brief  The end of the current window. No message from another
+        ///         process can be received before it.
+        ///
+        simulation::time_point horizon_ = 0;
+
+        ///
+        /// \brief  The earliest receive time of the messages from other
+        ///         processes delivered in the last exchange.
+        ///
+        simulation::time_point earliest_received_ = 0;
+
     public:
         ///
-        /// \brief
+        /// \brief  Agents are migrated away from processes whose measured
+        ///         load exceeds the mean load by more than this fraction.
+        ///
+        double tolerance = 0.1;
+
+        ///
+        /// \brief  The estimated cost of sending one message to another
+        ///         process, which is weighed against the computation that a
+        ///         migration moves.
+        ///
+        std::chrono::nanoseconds message_cost = std::chrono::microseconds(1);
+
+        ///
+        /// \brief  Messages to a process are sent as soon as this many are
+        ///         waiting, rather than at the end of the round.
+        ///
+        size_t message_chunk = 1024;
+
+        ///
+        /// \brief  When positive, agents are repartitioned after the first
+        ///         step, when the first messages have been observed, and
+        ///         then every this many steps. Migrated agents are sent as
+        ///         polymorphic pointers, so their types must be exported
+        ///         using BOOST_CLASS_EXPORT. Zero, the default, disables
+        ///         partitioning.
+        ///
+        std::uint64_t partition_interval = 0;
+
+        ///
+        /// \brief  Migrates agents away from overloaded processes in the
+        ///         steps between repartitions, which requires their types
+        ///         to be exported like `partition_interval` does. Off by
+        ///         default. When off and partitioning is disabled, no loads
+        ///         are gathered and no communication statistics are
+        ///         collected.
+        ///
+        bool load_balancing = false;
+
+        ///
+        /// \brief  Computes the assignment of agents to processes when
+        ///         repartitioning.
+        ///
+        partitioner partitioning;
+
+        ///
+        /// \brief  The minimum delay between sending and receiving a message
+        ///         to an agent on another process. When positive, processes
+        ///         advance independently through windows of this length, and
+        ///         exchange messages and synchronise only at the end of each
+        ///         window. Zero runs all processes in lockstep.
+        ///
+        /// \details    Conservative synchronisation in windows, after YAWNS:
+        ///             the next window starts at the earliest event on any
+        ///             process, so that no process receives a message in its
+        ///             past. Sending a message to another process that is
+        ///             received before the end of the window is an error.
+        ///             Messages between agents on the same process are
+        ///             delivered every round as before. This suits models
+        ///             activated by event with little interaction between
+        ///             processes; agents are migrated at the end of windows.
+        ///
+        simulation::time_duration lookahead = 0;
+
         ///
-        mpi_environment();
+        /// \param level    The MPI thread support to request. Models with
+        ///                 more than one thread need at least `funneled`.
+        explicit mpi_environment(boost::mpi::threading::level level =
+                                     boost::mpi::threading::funneled);
 
         ///
         /// \brief
@@ -89,6 +290,13 @@ namespace esl::computation::distributed {
         /// \param simulation The model to run in this environment.
         void run(simulation::model &simulation) override;
 
+    protected:
+        ///
+        /// \brief  Runs the model in windows of `lookahead`
+        ///
+        void run_windows(simulation::model &simulation,
+                         simulation::time_interval step);
+
     protected:
         ///
         /// \brief  Used to migrate agents between cluster nodes.
@@ -96,6 +304,12 @@ namespace esl::computation::distributed {
         /// \param simulation
         void migrate(simulation::model &simulation, agent_timing &timing);
 
+        ///
+        /// \brief  Migrates agents based on their measured load, and decays
+        ///         the communication statistics. Collective.
+        ///
+        void rebalance(simulation::model &simulation);
+
         ///
         /// \brief  Handles agents moving between MPI processes.
         ///
@@ -105,10 +319,29 @@ namespace esl::computation::distributed {
         ///
         /// \brief  Decide on which agents to move away from this process to
         ///         other MPI processes.
-        ///         Default behaviour is to not migrate any agent.
         ///
+        /// \details    The default moves measured agents from processes that
+        ///             are loaded above `tolerance` to processes below the
+        ///             mean load. Each overloaded process hands its surplus
+        ///             to the underloaded processes in proportion to their
+        ///             deficit, so that processes need not coordinate, and
+        ///             prefers agents that add the fewest remote messages per
+        ///             unit of computation moved.
+        ///
+        /// \param simulation
+        /// \param loads    The measured load of every process, in nanoseconds
         /// \return List of agents to move
-        virtual std::vector<migration> migrate_agents();
+        virtual std::vector<migration>
+        migrate_agents(simulation::model &simulation,
+                       const std::vector<std::int64_t> &loads);
+
+        ///
+        /// \brief  Gathers the communication graph on the coordinator, which
+        ///         computes a balanced assignment that cuts few messages.
+        ///         Collective.
+        ///
+        /// \return The migrations of the agents on this process
+        std::vector<migration> partition(simulation::model &simulation);
 
         ///
         /// \brief  agents are activated when they are newly created or when
@@ -136,6 +369,16 @@ namespace esl::computation::distributed {
         /// \param a
         void deactivate_agent(const identity<agent> &a) override;
 
+        ///
+        /// \brief  Applies an activation or deactivation on the main thread.
+        ///
+        void apply_change(const identity<agent> &a, bool activated);
+
+        ///
+        /// \brief  Applies the changes made on worker threads.
+        ///
+        void apply_changes();
+
         ///
         /// \brief  Tasks to do before the simulation performs a time step
         ///
@@ -154,12 +397,102 @@ namespace esl::computation::distributed {
         //          results are stored).
         bool is_coordinator() const;
 
+        ///
+        /// \brief  Moves the messages to agents on other processes from the
+        ///         agent's outbox to `remote_`, and sends the chunks that
+        ///         are full.
+        ///
+        void dispatch_remote(agent &a);
+
+        ///
+        /// \brief  Encodes and starts sending the messages in `remote_` for
+        ///         the process.
+        ///
+        void send_chunk(node_identifier process, int tag);
+
+        ///
+        /// \brief  Sends the last chunk of messages to every other process,
+        ///         which ends the exchange.
+        ///
+        void send_last_chunks();
+
+        ///
+        /// \brief  Receives and delivers the messages from all other
+        ///         processes, until each has sent its last chunk, and waits
+        ///         until the chunks of this process are sent.
+        ///
+        /// \return Number of messages received
+        size_t receive_remote(simulation::model &simulation);
+
+        ///
+        /// \return True if messages are counted for repartitioning or
+        ///         load balancing
+        bool measures_communication() const;
+
+        ///
+        /// \brief  Counts a message that the local agent exchanged with the
+        ///         process in the current round, for migration decisions.
+        ///
+        void count_message(simulation::agent_handle local, size_t process,
+                           double messages = 1.0);
+
+        ///
+        /// \brief  Adds the messages counted in the current round to the
+        ///         communication statistics and to the message graph.
+        ///         Expects `delivered_` sorted.
+        ///
+        void merge_communication(simulation::model &simulation);
+
+        ///
+        /// \brief  Puts the message in the inbox of its local recipient.
+        ///
+        /// \return The recipient
+        agent &deliver(simulation::model &simulation,
+                       std::shared_ptr<interaction::header> m);
+
+        ///
+        /// \brief  Starts sending the agent's messages to other processes,
+        ///         while the model computes the remaining agents.
+        ///
+        void agent_finished(agent &a) override;
+
+        ///
+        /// \brief  Dispatches the messages of agents that finished on worker
+        ///         threads.
+        ///
+        bool progress() override;
+
+        ///
+        /// \return The hardware threads of the node, divided over the
+        ///         processes on the node
+        unsigned int hardware_threads() const override;
+
         ///
         /// \param simulation
         ///
         /// \return Number of messages sent
         size_t send_messages(simulation::model &simulation) override;
 
+        ///
+        /// \return The minimum of the first events of all processes, or
+        ///         the first local event within a window
+        simulation::time_point
+        first_event(simulation::time_point first_event) override;
+
+        ///
+        /// \return The checkpoint path, followed by the process' rank
+        std::string checkpoint_file() const override;
+
+        ///
+        /// \brief  Resumes all processes from their latest common snapshot.
+        ///         Collective.
+        ///
+        simulation::time_point restore(simulation::model &simulation) override;
+
+        ///
+        /// \return True, because agents are migrated based on their timing
+        bool measures_agents() const override;
+
         void clear_agents(std::shared_ptr<simulation::model> simulation);
     };
 
@@ -0,0 +1,293 @@
+/// \file   partitioner.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <esl/computation/distributed/partitioner.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+
+
+namespace esl::computation::distributed {
+
+    namespace {
+        ///
+        /// \brief  Undirected communication graph in compressed sparse row
+        ///         format, with repeated edges merged.
+        ///
+        struct graph
+        {
+            std::vector<size_t> offsets;
+
+            std::vector<std::pair<size_t, double>> adjacent;
+
+            graph(const std::vector<partition_vertex> &vertices,
+                  const std::vector<partition_edge> &edges)
+            : offsets(vertices.size() + 1, 0)
+            {
+                std::unordered_map<identity<agent>, size_t> index_;
+                index_.reserve(vertices.size());
+                for(size_t i = 0; i < vertices.size(); ++i) {
+                    index_.insert({vertices[i].vertex, i});
+                }
+
+                std::vector<std::tuple<size_t, size_t, double>> directed_;
+                directed_.reserve(2 * edges.size());
+                for(const auto &e : edges) {
+                    auto s = index_.find(e.sender);
+                    auto r = index_.find(e.recipient);
+                    if(index_.end() == s || index_.end() == r
+                       || s->second == r->second) {
+                        continue;
+                    }
+                    directed_.emplace_back(s->second, r->second, e.weight);
+                    directed_.emplace_back(r->second, s->second, e.weight);
+                }
+                std::sort(directed_.begin(), directed_.end());
+
+                // sorted by source vertex, so only the offsets are needed
+                for(const auto &[from, to, weight] : directed_) {
+                    if(!adjacent.empty() && offsets[from + 1] > 0
+                       && adjacent.back().first == to) {
+                        adjacent.back().second += weight;
+                        continue;
+                    }
+                    adjacent.emplace_back(to, weight);
+                    ++offsets[from + 1];
+                }
+                for(size_t i = 1; i < offsets.size(); ++i) {
+                    offsets[i] += offsets[i - 1];
+                }
+            }
+        };
+    }  // namespace
+
+    std::vector<node_identifier>
+    partitioner::partition(const std::vector<partition_vertex> &vertices,
+                           const std::vector<partition_edge> &edges,
+                           node_identifier parts) const
+    {
+        const auto parts_ = size_t(std::max(1, parts));
+        std::vector<node_identifier> result_(vertices.size(), 0);
+        if(vertices.empty()) {
+            return result_;
+        }
+
+        const graph graph_(vertices, edges);
+
+        // unmeasured vertices weigh as much as the average measured vertex
+        double measured_ = 0.0;
+        size_t count_    = 0;
+        for(const auto &v : vertices) {
+            if(0.0 < v.weight) {
+                measured_ += v.weight;
+                ++count_;
+            }
+        }
+        const double unmeasured_ = 0 < count_ ? measured_ / double(count_) : 1.0;
+
+        std::vector<double> weight_(vertices.size());
+        std::vector<double> load_(parts_, 0.0);
+        double total_ = 0.0;
+        double heaviest_ = 0.0;
+        for(size_t i = 0; i < vertices.size(); ++i) {
+            weight_[i] = 0.0 < vertices[i].weight ? vertices[i].weight : unmeasured_;
+            result_[i] = 0 <= vertices[i].location
+                                 && size_t(vertices[i].location) < parts_
+                             ? vertices[i].location : 0;
+            load_[result_[i]] += weight_[i];
+            total_ += weight_[i];
+            heaviest_ = std::max(heaviest_, weight_[i]);
+        }
+        const double capacity_ =
+            std::max(heaviest_, (1.0 + tolerance) * total_ / double(parts_));
+
+        // messages between the vertex and each process
+        std::vector<double> connectivity_(parts_, 0.0);
+        auto connect_ = [&](size_t i) {
+            std::fill(connectivity_.begin(), connectivity_.end(), 0.0);
+            for(auto j = graph_.offsets[i]; j < graph_.offsets[i + 1]; ++j) {
+                const auto &[to, weight] = graph_.adjacent[j];
+                connectivity_[result_[to]] += weight;
+            }
+        };
+
+        auto move_ = [&](size_t i, size_t target) {
+            load_[result_[i]] -= weight_[i];
+            load_[target]     += weight_[i];
+            result_[i] = node_identifier(target);
+        };
+
+        // the process with room for the vertex that it talks to most, ties
+        // going to the lightest process
+        auto target_ = [&](size_t i) {
+            size_t best_ = parts_;
+            for(size_t p = 0; p < parts_; ++p) {
+                if(node_identifier(p) == result_[i]
+                   || load_[p] + weight_[i] > capacity_) {
+                    continue;
+                }
+                if(parts_ == best_ || connectivity_[p] > connectivity_[best_]
+                   || (connectivity_[p] == connectivity_[best_]
+                       && load_[p] < load_[best_])) {
+                    best_ = p;
+                }
+            }
+            return best_;
+        };
+
+        // balance: move the vertices that lose least communication out of
+        // processes that exceed their capacity
+        for(size_t p = 0; p < parts_; ++p) {
+            if(load_[p] <= capacity_) {
+                continue;
+            }
+            std::vector<std::pair<double, size_t>> candidates_;
+            for(size_t i = 0; i < vertices.size(); ++i) {
+                if(node_identifier(p) != result_[i]) {
+                    continue;
+                }
+                connect_(i);
+                auto t = target_(i);
+                double elsewhere_ = parts_ == t ? 0.0 : connectivity_[t];
+                candidates_.emplace_back(connectivity_[p] - elsewhere_, i);
+            }
+            std::sort(candidates_.begin(), candidates_.end());
+            for(const auto &[loss, i] : candidates_) {
+                (void)loss;
+                if(load_[p] <= capacity_) {
+                    break;
+                }
+                connect_(i);
+                auto t = target_(i);
+                if(parts_ != t) {
+                    move_(i, t);
+                }
+            }
+        }
+
+        // refine: move vertices to the process they talk to most, while this
+        // strictly reduces the cut
+        std::vector<std::vector<std::pair<double, size_t>>> wanting_(
+            parts_ * parts_);
+        for(unsigned int pass = 0; pass < passes; ++pass) {
+            bool moved_ = false;
+            for(size_t i = 0; i < vertices.size(); ++i) {
+                connect_(i);
+                auto t = target_(i);
+                if(parts_ != t
+                   && connectivity_[t] > connectivity_[result_[i]]) {
+                    move_(i, t);
+                    moved_ = true;
+                }
+            }
+
+            // processes that are full can still exchange vertices. Vertices
+            // are listed by the process they talk to most, regardless of
+            // capacity, and paired off with the opposite list
+            for(auto &w : wanting_) {
+                w.clear();
+            }
+            for(size_t i = 0; i < vertices.size(); ++i) {
+                connect_(i);
+                size_t own_  = size_t(result_[i]);
+                size_t best_ = own_;
+                for(size_t p = 0; p < parts_; ++p) {
+                    if(p != own_ && 0.0 < connectivity_[p]
+                       && (own_ == best_ || connectivity_[p] > connectivity_[best_])) {
+                        best_ = p;
+                    }
+                }
+                if(own_ != best_) {
+                    wanting_[own_ * parts_ + best_].emplace_back(
+                        connectivity_[own_] - connectivity_[best_], i);
+                }
+            }
+            for(size_t a = 0; a < parts_; ++a) {
+                for(size_t b = a + 1; b < parts_; ++b) {
+                    auto &forward_  = wanting_[a * parts_ + b];
+                    auto &backward_ = wanting_[b * parts_ + a];
+                    std::sort(forward_.begin(), forward_.end());
+                    std::sort(backward_.begin(), backward_.end());
+                    size_t f = 0;
+                    size_t k = 0;
+                    while(f < forward_.size() && k < backward_.size()) {
+                        // the lists are sorted by the gain of moving alone,
+                        // so no later pair can gain more
+                        if(0.0 <= forward_[f].first + backward_[k].first) {
+                            break;
+                        }
+                        auto i = forward_[f].second;
+                        auto j = backward_[k].second;
+                        connect_(i);
+                        double gain_ = connectivity_[b] - connectivity_[a];
+                        move_(i, b);
+                        // includes the edge between i and j, if any
+                        connect_(j);
+                        gain_ += connectivity_[a] - connectivity_[b];
+                        move_(j, a);
+                        if(gain_ <= 0.0 || load_[a] > capacity_
+                           || load_[b] > capacity_) {
+                            // try i with the next candidate, j is left for
+                            // the next pass
+                            move_(j, b);
+                            move_(i, a);
+                            ++k;
+                            continue;
+                        }
+                        moved_ = true;
+                        ++f;
+                        ++k;
+                    }
+                }
+            }
+
+            if(!moved_) {
+                break;
+            }
+        }
+        return result_;
+    }
+
+    double partitioner::cut(const std::vector<partition_vertex> &vertices,
+                            const std::vector<partition_edge> &edges,
+                            const std::vector<node_identifier> &assignment)
+    {
+        std::unordered_map<identity<agent>, node_identifier> location_;
+        for(size_t i = 0; i < vertices.size(); ++i) {
+            location_.insert({vertices[i].vertex, assignment[i]});
+        }
+        double result_ = 0.0;
+        for(const auto &e : edges) {
+            auto s = location_.find(e.sender);
+            auto r = location_.find(e.recipient);
+            if(location_.end() != s && location_.end() != r
+               && s->second != r->second) {
+                result_ += e.weight;
+            }
+        }
+        return result_;
+    }
+}  // namespace esl::computation::distributed
@@ -0,0 +1,133 @@
+/// \file   partitioner.hpp
+///
+/// \brief  Assigns agents to processes so that agents that exchange many\nmessages share a process, while keeping the processes balanced.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_COMPUTATION_DISTRIBUTED_PARTITIONER_HPP
+#define ESL_COMPUTATION_DISTRIBUTED_PARTITIONER_HPP
+
+#include <vector>
+
+#include <boost/serialization/nvp.hpp>
+
+#include <esl/computation/distributed/protocol.hpp>
+#include <esl/simulation/identity.hpp>
+
+
+namespace esl::computation::distributed {
+
+    ///
+    /// \brief  An agent in the communication graph, with its current process
+    ///         and its computational cost.
+    ///
+    struct partition_vertex
+    {
+        identity<agent> vertex;
+
+        node_identifier location;
+
+        double weight;
+
+        template<class archive_t>
+        void serialize(archive_t &archive, const unsigned int version)
+        {
+            (void)version;
+            archive & BOOST_SERIALIZATION_NVP(vertex);
+            archive & BOOST_SERIALIZATION_NVP(location);
+            archive & BOOST_SERIALIZATION_NVP(weight);
+        }
+    };
+
+    ///
+    /// \brief  The number of messages sent from one agent to another.
+    ///
+    struct partition_edge
+    {
+        identity<agent> sender;
+
+        identity<agent> recipient;
+
+        double weight;
+
+        template<class archive_t>
+        void serialize(archive_t &archive, const unsigned int version)
+        {
+            (void)version;
+            archive & BOOST_SERIALIZATION_NVP(sender);
+            archive & BOOST_SERIALIZATION_NVP(recipient);
+            archive & BOOST_SERIALIZATION_NVP(weight);
+        }
+    };
+
+    ///
+    /// \brief  Computes a balanced assignment of agents to processes that
+    ///         cuts few messages, starting from the current assignment.
+    ///
+    /// \details    First, agents are moved out of processes that exceed their
+    ///             capacity, choosing the agents that lose the least
+    ///             communication. Then, agents are moved one at a time to the
+    ///             process they exchange most messages with, as long as
+    ///             this reduces the number of messages between processes and
+    ///             the target has capacity. Processes that are full
+    ///             exchange pairs of agents instead, when the exchange
+    ///             reduces the cut. Balancing visits the agents of each
+    ///             process once, and may increase the cut. The refinement
+    ///             only reduces it, and stops after a pass that moves no
+    ///             agent, or after `passes` passes. The result is
+    ///             deterministic in the order of the vertices.
+    ///
+    class partitioner
+    {
+    public:
+        ///
+        /// \brief  The weight of a process may exceed the mean weight by
+        ///         this fraction.
+        ///
+        double tolerance = 0.05;
+
+        ///
+        /// \brief  Maximum number of passes over all vertices.
+        ///
+        unsigned int passes = 8;
+
+        ///
+        /// \param vertices Every agent, once
+        /// \param edges    Messages between agents. Edges may be repeated,
+        ///                 and edges to unknown agents are ignored.
+        /// \param parts    Number of processes
+        /// \return The new process of every vertex, in the order of `vertices`
+        std::vector<node_identifier>
+        partition(const std::vector<partition_vertex> &vertices,
+                  const std::vector<partition_edge> &edges,
+                  node_identifier parts) const;
+
+        ///
+        /// \return The total weight of edges between vertices on different
+        ///         processes under the assignment.
+        static double cut(const std::vector<partition_vertex> &vertices,
+                          const std::vector<partition_edge> &edges,
+                          const std::vector<node_identifier> &assignment);
+    };
+
+}  // namespace esl::computation::distributed
+
+#endif  // ESL_COMPUTATION_DISTRIBUTED_PARTITIONER_HPP
@@ -22,9 +22,11 @@
 ///             You may obtain instructions to fulfill the attribution
 ///             requirements in CITATION.cff
 ///
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <chrono>
+#include <thread>
 using std::chrono::high_resolution_clock;
 
 #include <boost/archive/xml_oarchive.hpp>
@@ -136,27 +138,168 @@ namespace esl::computation {
     {
         size_t messages_ = 0;
 
-        // agent locality refers to memory locality. In the multi-threaded
-        // setting, we are still able to observe all agents from one thread
-        for(auto &[i, a] :simulation.agents.local_agents_){
-            (void)i;
-            for(const auto &m :a->outbox){
-                auto iterator_ = simulation.agents.local_agents_.find(m->recipient);
-                if(simulation.agents.local_agents_.end() == iterator_) {
+        auto deliver_ = [&](agent &a) {
+            for(auto &m :a.outbox){
+                auto *recipient_ = simulation.agents.find(m->recipient);
+                if(nullptr == recipient_) {
                     // not in distributed mode, and no local agent matching recipient
                     throw esl::exception("message recipient agent not found "
                                            + m->recipient.representation());
                 }
-                iterator_->second->inbox.insert({m->received, m});
+                // the outbox is cleared after delivery, so the reference is
+                // moved rather than copied
+                recipient_->inbox.insert({m->received, std::move(m)});
+                if(simulation.agents.event_driven) {
+                    simulation.agents.wake(recipient_);
+                }
                 ++messages_;
             }
 
-            a->outbox.clear();
+            a.outbox.clear();
             //TODO: make a->outbox.shrink_to_fit(); optional
+        };
+
+        if(simulation.pool_) {
+            senders_.clear();
+            if(simulation::model::by_event == simulation.activation) {
+                senders_ = simulation.scheduled_agents();
+            }else{
+                for(auto *a : simulation.agents.slots()) {
+                    if(nullptr != a) {
+                        senders_.push_back(a);
+                    }
+                }
+            }
+            return send_messages_parallel(simulation);
+        }
+
+        // only agents that ran can have sent messages
+        if(simulation::model::by_event == simulation.activation) {
+            for(auto *a : simulation.scheduled_agents()) {
+                deliver_(*a);
+            }
+            return messages_;
+        }
+
+        // agent locality refers to memory locality. In the multi-threaded
+        // setting, we are still able to observe all agents from one thread
+        for(auto *a : simulation.agents.slots()) {
+            if(nullptr != a) {
+                deliver_(*a);
+            }
+        }
+        return messages_;
+    }
+
+
+    size_t environment::send_messages_parallel(simulation::model &simulation)
+    {
+        const unsigned int workers_ = simulation.threads;
+        const unsigned int shards_  = simulation.threads;
+        const bool wake_ = simulation.agents.event_driven;
+
+        deliveries_.resize(workers_);
+        for(auto &w : deliveries_) {
+            w.resize(shards_);
+        }
+        if(record_deliveries_ && delivered_.size() < workers_) {
+            delivered_.resize(workers_);
+        }
+        // positions of the messages in the sequential delivery
+        first_message_.resize(senders_.size());
+        size_t messages_ = 0;
+        for(size_t j = 0; j < senders_.size(); ++j) {
+            first_message_[j] = messages_;
+            messages_ += senders_[j]->outbox.size();
+        }
+        if(wake_) {
+            wake_order_.assign(messages_, nullptr);
+        }
+
+        // phase 1: each worker resolves the recipients of a contiguous range
+        // of senders, and sorts the messages by recipient shard
+        const size_t chunk_ = (senders_.size() + workers_ - 1) / workers_;
+        simulation.pool_->fork_join(workers_, [&](unsigned int t) {
+            auto &buckets_ = deliveries_[t];
+            for(auto &b : buckets_) {
+                b.clear();
+            }
+
+            size_t begin_ = std::min(senders_.size(), t * chunk_);
+            size_t end_   = std::min(senders_.size(), begin_ + chunk_);
+            for(size_t j = begin_; j < end_; ++j) {
+                agent &a = *senders_[j];
+                size_t order_ = first_message_[j];
+                for(auto &m : a.outbox) {
+                    auto *recipient_ = simulation.agents.find(m->recipient);
+                    if(nullptr == recipient_) {
+                        // not in distributed mode, and no local agent matching recipient
+                        throw esl::exception("message recipient agent not found "
+                                             + m->recipient.representation());
+                    }
+                    if(record_deliveries_) {
+                        delivered_[t].emplace_back(a.handle(), recipient_->handle());
+                    }
+                    auto shard_ = recipient_->handle() % shards_;
+                    buckets_[shard_].push_back({recipient_, std::move(m), order_++});
+                }
+                a.outbox.clear();
+            }
+            if(record_deliveries_) {
+                std::sort(delivered_[t].begin(), delivered_[t].end());
+            }
+        });
+
+        // phase 2: each shard is merged by one worker, taking the buckets in
+        // worker order so that every inbox sees messages in sender order
+        simulation.pool_->fork_join(shards_, [&](unsigned int s) {
+            for(unsigned int t = 0; t < workers_; ++t) {
+                for(auto &d : deliveries_[t][s]) {
+                    if(wake_) {
+                        wake_order_[d.order] = d.recipient;
+                    }
+                    d.recipient->inbox.insert({d.message->received, std::move(d.message)});
+                }
+                deliveries_[t][s].clear();
+            }
+        });
+
+        // waking is not thread-safe. Like the sequential delivery, every
+        // message wakes its recipient, which is a no-op once it is queued
+        if(wake_) {
+            for(auto *a : wake_order_) {
+                simulation.agents.wake(a);
+            }
         }
         return messages_;
     }
 
+    void environment::agent_finished(agent &a)
+    {
+        (void)a;
+    }
+
+    bool environment::progress()
+    {
+        return false;
+    }
+
+    unsigned int environment::hardware_threads() const
+    {
+        // hardware_concurrency is not guaranteed to work well on any OS
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    simulation::time_point
+    environment::first_event(simulation::time_point first_event)
+    {
+        return first_event;
+    }
+
+    bool environment::measures_agents() const
+    {
+        return false;
+    }
 
     ///
     /// \param a
@@ -187,6 +330,41 @@ namespace esl::computation {
         changes_ += deactivate();
     }
 
+    std::string environment::checkpoint_file() const
+    {
+        return checkpoints.path;
+    }
+
+    simulation::time_point environment::restore(simulation::model &simulation)
+    {
+        const auto file_ = checkpoint_file();
+        // the writer moves the latest snapshot aside before putting the new
+        // one in place, so a run stopped in between only has `.previous`
+        const std::string files_[2] = {file_, file_ + ".previous"};
+        for(const auto &f : files_) {
+            if(!checkpoints.enabled() || !checkpoint::peek(f)) {
+                continue;
+            }
+            auto time_ = checkpoints.load(simulation, f);
+            // the restored agents are already known to the environment
+            activated_.clear();
+            deactivated_.clear();
+            LOG(notice) << "resuming from checkpoint " << f << " at time "
+                        << time_ << std::endl;
+            return time_;
+        }
+        checkpoints.start(simulation.start);
+        return simulation.start;
+    }
+
+    void environment::save_checkpoint(simulation::model &simulation,
+                                      simulation::time_point time)
+    {
+        if(time < simulation.end && checkpoints.due(time)) {
+            checkpoints.save(simulation, time, checkpoint_file());
+        }
+    }
+
     ///
     /// \param simulation
     void environment::run(simulation::model &simulation)
@@ -195,14 +373,16 @@ namespace esl::computation {
         simulation.initialize();
         auto timer_initialization_ = high_resolution_clock::now() - timer_start_run_;
 
-        simulation::time_interval step_ = {simulation.start, simulation.end};
-        do {
+        simulation::time_interval step_ = {restore(simulation), simulation.end};
+        while(step_.lower < simulation.end) {
             size_t changes_ = 0;
             changes_ += activate();
             changes_ += deactivate();
 
             step_.lower = simulation.step(step_);
-        } while(step_.lower < simulation.end);
+            save_checkpoint(simulation, step_.lower);
+        }
+        checkpoints.wait();
         auto timer_simulation_ = high_resolution_clock::now() - timer_start_run_;
 
         LOG(notice) << "simulation took "
@@ -26,10 +26,16 @@
 #ifndef ESL_COMPUTATION_ENVIRONMENT_HPP
 #define ESL_COMPUTATION_ENVIRONMENT_HPP
 
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <esl/computation/checkpoint.hpp>
+#include <esl/simulation/agent_handle.hpp>
 #include <esl/simulation/identity.hpp>
+#include <esl/simulation/time.hpp>
 
 
 namespace esl {
@@ -37,6 +43,11 @@ namespace esl {
 }
 
 
+namespace esl::interaction {
+    struct header;
+}
+
+
 namespace esl::simulation {
     class model;
     class agent_collection;
@@ -68,7 +79,103 @@ namespace esl::computation {
         ///
         std::vector<identity<agent>> deactivated_;
 
+        ///
+        /// \brief  A message paired with its resolved local recipient.
+        ///
+        struct delivery
+        {
+            agent *recipient;
+            std::shared_ptr<interaction::header> message;
+
+            ///
+            /// \brief  Position of the message in the sequential delivery
+            ///
+            size_t order;
+        };
+
+        ///
+        /// \brief  Messages to deliver, indexed by the worker that collected
+        ///         them and then by the recipient's shard. Capacity is kept
+        ///         between rounds.
+        ///
+        std::vector<std::vector<std::vector<delivery>>> deliveries_;
+
+        ///
+        /// \brief  The agents whose outboxes are delivered, in the order used
+        ///         by the sequential delivery.
+        ///
+        std::vector<agent *> senders_;
+
+        ///
+        /// \brief  Per sender, the position of its first message in the
+        ///         sequential delivery
+        ///
+        std::vector<size_t> first_message_;
+
+        ///
+        /// \brief  The recipient of every message, at the message's position
+        ///         in the sequential delivery, so that event activated
+        ///         models wake recipients in the same order for any number
+        ///         of threads.
+        ///
+        std::vector<agent *> wake_order_;
+
+        ///
+        /// \brief  When set, the deliveries record the handles of the
+        ///         sender and recipient of every local message in
+        ///         `delivered_`, sorted per worker.
+        ///
+        bool record_deliveries_ = false;
+
+        ///
+        /// \brief  Sender and recipient handles of the delivered messages,
+        ///         by the worker that delivered them. Cleared by the
+        ///         environment that consumes them.
+        ///
+        std::vector<std::vector<std::pair<simulation::agent_handle,
+                                          simulation::agent_handle>>>
+            delivered_;
+
+        ///
+        /// \brief  Delivers the outboxes of `senders_` using the model's
+        ///         thread pool.
+        ///
+        /// \details    Workers first sort the messages of contiguous ranges
+        ///             of senders into shards by recipient, then each shard
+        ///             is merged into its recipients' inboxes by one worker.
+        ///             Every recipient belongs to one shard and its shard is
+        ///             merged in sender order, so inboxes end up identical
+        ///             to those built by the sequential delivery. Recipients
+        ///             are woken in the order of the sequential delivery.
+        ///
+        size_t send_messages_parallel(simulation::model &simulation);
+
+        ///
+        /// \return The file this process saves its snapshots to
+        virtual std::string checkpoint_file() const;
+
+        ///
+        /// \brief  Resumes the model from its latest snapshot, if there is
+        ///         one.
+        ///
+        /// \return The time at which the model resumes
+        virtual simulation::time_point restore(simulation::model &simulation);
+
+        ///
+        /// \brief  Saves a snapshot of the model when one is due.
+        ///
+        /// \param time The time at which the model resumes
+        void save_checkpoint(simulation::model &simulation,
+                             simulation::time_point time);
+
     public:
+        ///
+        /// \brief  Saves snapshots of the model while it runs, and resumes
+        ///         the run from the latest snapshot when `checkpoints.path`
+        ///         is set and the snapshot exists.
+        ///
+        checkpoint checkpoints;
+
         ///
         ///
         ///
@@ -137,10 +244,51 @@ namespace esl::computation {
         /// \param a
         virtual void deactivate_agent(const identity<agent> &a);
 
+        ///
+        /// \brief  Called after the agent ran in a round. Environments may
+        ///         start to send the agent's messages, but must not deliver
+        ///         them before `send_messages`.
+        ///
+        /// \details    When the model uses a thread pool, this is called on
+        ///             the worker that ran the agent, concurrently with other
+        ///             workers.
+        ///
+        virtual void agent_finished(agent &a);
+
+        ///
+        /// \brief  Called repeatedly on the model's thread while the workers
+        ///         of its thread pool run agents.
+        ///
+        /// \return True if there was work to do
+        virtual bool progress();
+
+        ///
+        /// \brief  The number of threads a model may use when its `threads`
+        ///         parameter is zero.
+        ///
+        virtual unsigned int hardware_threads() const;
+
         ///
         /// \param simulation
         /// \return
         virtual size_t send_messages(simulation::model &simulation);
+
+        ///
+        /// \brief  Combines the first event of this process with that of
+        ///         the other processes at the end of each round, so that all
+        ///         processes run the same rounds.
+        ///
+        /// \param first_event  The earliest event of the local agents
+        /// \return The earliest event of all agents
+        virtual simulation::time_point
+        first_event(simulation::time_point first_event);
+
+        ///
+        /// \brief  Whether the model should measure the time spent on each
+        ///         agent in `agent::timing`, also when its scheduler does
+        ///         not need it.
+        ///
+        virtual bool measures_agents() const;
     };
 }  // namespace esl::computation
 
@@ -0,0 +1,237 @@
+/// \file   hierarchical_bitmap.hpp
+///
+/// \brief  Bitmap with summary levels, to find the nearest set bit in a few
+///         word operations
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_HIERARCHICAL_BITMAP_HPP
+#define ESL_HIERARCHICAL_BITMAP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+namespace esl::computation {
+
+    ///
+    /// \brief  A bitmap of fixed size with summary levels on top, where each
+    ///         bit in a level above tells whether the corresponding 64-bit
+    ///         word in the level below has any bit set.
+    ///
+    /// \details    Searching for the next or previous set bit visits at most
+    ///             two words per level, so with three levels over 2^18 bits
+    ///             a search takes a handful of instructions however sparse
+    ///             the bitmap is.
+    ///
+    class hierarchical_bitmap
+    {
+    public:
+        typedef std::uint64_t word_t;
+
+        ///
+        /// \brief  Returned by searches that find no set bit
+        ///
+        constexpr static const std::size_t npos =
+            std::numeric_limits<std::size_t>::max();
+
+    private:
+        constexpr static const std::size_t bits_ = 64;
+
+        ///
+        /// \brief  `levels_.front()` holds one bit per element, every next
+        ///         level one bit per word of the level before it, and the
+        ///         last level is a single word.
+        ///
+        std::vector<std::vector<word_t>> levels_;
+
+        std::size_t size_;
+
+        static unsigned int lowest(word_t w)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return unsigned(__builtin_ctzll(w));
+#else
+            unsigned int i = 0;
+            while(!(w & 1u)) {
+                w >>= 1;
+                ++i;
+            }
+            return i;
+#endif
+        }
+
+        static unsigned int highest(word_t w)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63u - unsigned(__builtin_clzll(w));
+#else
+            unsigned int i = 0;
+            while(w >>= 1) {
+                ++i;
+            }
+            return i;
+#endif
+        }
+
+    public:
+        explicit hierarchical_bitmap(std::size_t size = 0)
+        {
+            resize(size);
+        }
+
+        ///
+        /// \brief  Changes the number of bits, and clears all of them
+        ///
+        void resize(std::size_t size)
+        {
+            size_ = size;
+            levels_.clear();
+            std::size_t words_ = (size + bits_ - 1) / bits_;
+            do {
+                words_ = std::max<std::size_t>(1, words_);
+                levels_.emplace_back(words_, 0);
+                words_ = (words_ + bits_ - 1) / bits_;
+            } while(1 < levels_.back().size());
+        }
+
+        ///
+        /// \brief  Clears all bits, keeping the size
+        ///
+        void clear()
+        {
+            for(auto &level_: levels_) {
+                std::fill(level_.begin(), level_.end(), 0);
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return 0 == levels_.back().front();
+        }
+
+        [[nodiscard]] bool test(std::size_t i) const
+        {
+            return 0 != (levels_.front()[i / bits_] & (word_t(1) << (i % bits_)));
+        }
+
+        void set(std::size_t i)
+        {
+            for(auto &level_: levels_) {
+                auto &word_ = level_[i / bits_];
+                bool was_empty_ = (0 == word_);
+                word_ |= word_t(1) << (i % bits_);
+                if(!was_empty_) {
+                    return;
+                }
+                i /= bits_;
+            }
+        }
+
+        void reset(std::size_t i)
+        {
+            for(auto &level_: levels_) {
+                auto &word_ = level_[i / bits_];
+                word_ &= ~(word_t(1) << (i % bits_));
+                if(0 != word_) {
+                    return;
+                }
+                i /= bits_;
+            }
+        }
+
+        ///
+        /// \brief  The position of the first set bit at or after `i`
+        ///
+        /// \return npos if there is none
+        [[nodiscard]] std::size_t next(std::size_t i) const
+        {
+            if(i >= size_) {
+                return npos;
+            }
+            std::size_t level_ = 0;
+            // ascend until a word has a set bit at or after the position
+            for(;;) {
+                auto word_ = i / bits_;
+                if(word_ >= levels_[level_].size()) {
+                    return npos;
+                }
+                auto masked_ = levels_[level_][word_]
+                             & (~word_t(0) << (i % bits_));
+                if(masked_) {
+                    i = word_ * bits_ + lowest(masked_);
+                    break;
+                }
+                if(++level_ == levels_.size()) {
+                    return npos;
+                }
+                i = word_ + 1;
+            }
+            // descend along the lowest set bits
+            while(0 < level_) {
+                --level_;
+                i = i * bits_ + lowest(levels_[level_][i]);
+            }
+            return i;
+        }
+
+        ///
+        /// \brief  The position of the last set bit at or before `i`
+        ///
+        /// \return npos if there is none
+        [[nodiscard]] std::size_t previous(std::size_t i) const
+        {
+            if(0 == size_) {
+                return npos;
+            }
+            i = std::min(i, size_ - 1);
+            std::size_t level_ = 0;
+            for(;;) {
+                auto word_ = i / bits_;
+                auto masked_ = levels_[level_][word_]
+                             & (~word_t(0) >> (bits_ - 1 - i % bits_));
+                if(masked_) {
+                    i = word_ * bits_ + highest(masked_);
+                    break;
+                }
+                if(0 == word_ || ++level_ == levels_.size()) {
+                    return npos;
+                }
+                i = word_ - 1;
+            }
+            while(0 < level_) {
+                --level_;
+                i = i * bits_ + highest(levels_[level_][i]);
+            }
+            return i;
+        }
+    };
+
+}  // namespace esl::computation
+
+#endif  // ESL_HIERARCHICAL_BITMAP_HPP
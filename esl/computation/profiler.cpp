@@ -0,0 +1,242 @@
+/// \file   profiler.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <esl/computation/profiler.hpp>
+
+#include <algorithm>
+
+
+namespace esl::computation {
+
+    void profiler::counters::merge(const counters &o)
+    {
+        calls += o.calls;
+        total += o.total;
+        for(size_t b = 0; b < buckets; ++b) {
+            histogram[b] += o.histogram[b];
+        }
+    }
+
+    profiler::statistics profiler::counters::summarize(site_t id) const
+    {
+        statistics result_ = {id, calls, std::chrono::nanoseconds(total),
+                              std::chrono::nanoseconds(0)};
+        // the smallest bucket that contains at least 99% of calls
+        std::uint64_t threshold_ = (calls * 99 + 99) / 100;
+        std::uint64_t cumulative_ = 0;
+        for(size_t b = 0; b < buckets; ++b) {
+            cumulative_ += histogram[b];
+            if(0 < histogram[b] && threshold_ <= cumulative_) {
+                result_.p99 = std::chrono::nanoseconds(bucket_upper(b));
+                break;
+            }
+        }
+        return result_;
+    }
+
+    profiler::thread_counters::~thread_counters()
+    {
+        profiler::instance().retire(*this);
+    }
+
+    profiler::profiler()
+    : enabled_(false)
+    {
+
+    }
+
+    profiler &profiler::instance()
+    {
+        static profiler instance_;
+        return instance_;
+    }
+
+    size_t profiler::bucket(std::uint64_t nanoseconds)
+    {
+        if(nanoseconds < 4) {
+            return size_t(nanoseconds);
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        unsigned int exponent_ = 63u - unsigned(__builtin_clzll(nanoseconds));
+#else
+        unsigned int exponent_ = 2;
+        while(nanoseconds >> (exponent_ + 1)) {
+            ++exponent_;
+        }
+#endif
+        // the two bits after the leading bit select one of four sub-buckets
+        auto sub_ = (nanoseconds >> (exponent_ - 2)) & 3u;
+        return 4 * (exponent_ - 1) + size_t(sub_);
+    }
+
+    std::uint64_t profiler::bucket_upper(size_t bucket)
+    {
+        if(bucket < 4) {
+            return bucket;
+        }
+        auto exponent_ = unsigned(bucket / 4 + 1);
+        auto lower_ = std::uint64_t(4 + bucket % 4) << (exponent_ - 2);
+        return lower_ + (std::uint64_t(1) << (exponent_ - 2)) - 1;
+    }
+
+    profiler::thread_counters &profiler::local()
+    {
+        thread_local thread_counters counters_;
+        thread_local bool registered_ = false;
+        if(!registered_) {
+            std::lock_guard lock_(mutex_);
+            threads_.push_back(&counters_);
+            registered_ = true;
+        }
+        return counters_;
+    }
+
+    void profiler::retire(thread_counters &t)
+    {
+        std::lock_guard lock_(mutex_);
+        threads_.erase(std::remove(threads_.begin(), threads_.end(), &t),
+                       threads_.end());
+        if(retired_.size() < t.sites.size()) {
+            retired_.resize(t.sites.size());
+        }
+        for(size_t s = 0; s < t.sites.size(); ++s) {
+            retired_[s].merge(t.sites[s]);
+        }
+    }
+
+    profiler::site_t profiler::register_site( const std::string &description
+                                            , const std::string &message
+                                            , const std::string &file
+                                            , size_t line)
+    {
+        std::lock_guard lock_(mutex_);
+        auto key_ = std::make_tuple(description, message, file, line);
+        auto i = index_.find(key_);
+        if(index_.end() != i) {
+            return i->second;
+        }
+        auto id_ = site_t(sites_.size());
+        sites_.push_back({description, message, file, line});
+        index_.emplace(std::move(key_), id_);
+        return id_;
+    }
+
+    void profiler::aggregate()
+    {
+        std::lock_guard lock_(mutex_);
+        step_.assign(sites_.size(), counters());
+        totals_.resize(sites_.size());
+
+        auto collect_ = [&](std::vector<counters> &sites) {
+            for(size_t s = 0; s < sites.size(); ++s) {
+                if(0 < sites[s].calls) {
+                    step_[s].merge(sites[s]);
+                    sites[s] = counters();
+                }
+            }
+        };
+        for(auto *t : threads_) {
+            collect_(t->sites);
+        }
+        collect_(retired_);
+
+        for(size_t s = 0; s < step_.size(); ++s) {
+            totals_[s].merge(step_[s]);
+        }
+    }
+
+    void profiler::reset()
+    {
+        std::lock_guard lock_(mutex_);
+        for(auto *t : threads_) {
+            t->sites.clear();
+        }
+        retired_.clear();
+        step_.clear();
+        totals_.clear();
+    }
+
+    std::vector<profiler::statistics> profiler::last_step() const
+    {
+        std::lock_guard lock_(mutex_);
+        std::vector<statistics> result_;
+        for(size_t s = 0; s < step_.size(); ++s) {
+            if(0 < step_[s].calls) {
+                result_.push_back(step_[s].summarize(site_t(s)));
+            }
+        }
+        return result_;
+    }
+
+    std::vector<profiler::statistics> profiler::totals() const
+    {
+        std::lock_guard lock_(mutex_);
+        std::vector<statistics> result_;
+        for(size_t s = 0; s < totals_.size(); ++s) {
+            if(0 < totals_[s].calls) {
+                result_.push_back(totals_[s].summarize(site_t(s)));
+            }
+        }
+        return result_;
+    }
+
+    profiler::site profiler::where(site_t id) const
+    {
+        std::lock_guard lock_(mutex_);
+        return sites_.at(id);
+    }
+
+    void profiler::write_report(std::ostream &stream) const
+    {
+        auto rows_ = totals();
+        std::sort(rows_.begin(), rows_.end(),
+                  [](const statistics &a, const statistics &b) {
+                      return a.total > b.total;
+                  });
+
+        // quotes are doubled in quoted fields
+        auto quote_ = [](const std::string &s) {
+            std::string result_ = "\"";
+            for(auto c : s) {
+                result_ += c;
+                if('"' == c) {
+                    result_ += c;
+                }
+            }
+            return result_ + "\"";
+        };
+
+        stream << "description,message,file,line,calls,total_ns,p99_ns" << std::endl;
+        for(const auto &s : rows_) {
+            auto site_ = where(s.id);
+            stream << quote_(site_.description) << ','
+                   << quote_(site_.message) << ','
+                   << quote_(site_.file) << ','
+                   << site_.line << ','
+                   << s.calls << ','
+                   << s.total.count() << ','
+                   << s.p99.count() << std::endl;
+        }
+    }
+}  // namespace esl::computation
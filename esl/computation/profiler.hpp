@@ -0,0 +1,235 @@
+/// \file   profiler.hpp
+///
+/// \brief  Measures the time spent in message callbacks.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_COMPUTATION_PROFILER_HPP
+#define ESL_COMPUTATION_PROFILER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+namespace esl::computation {
+
+    ///
+    /// \brief  Process-wide profiler for message callbacks.
+    ///
+    /// \details    Every distinct callback (by description, message, file and
+    ///             line) is registered once as a site, however many agents
+    ///             register it. Threads record calls into their own counters
+    ///             indexed by site, so that recording takes no locks and no
+    ///             string lookups. `aggregate` merges the counters of all
+    ///             threads into per-step and total statistics. The model
+    ///             calls it after every step, when no callbacks are running.
+    ///
+    ///             Profiling is compiled in when `WITH_PROFILING` is defined,
+    ///             and is then switched on and off at run time with
+    ///             `enable`. It is off by default.
+    ///
+    class profiler
+    {
+    public:
+        typedef std::uint32_t site_t;
+
+        ///
+        /// \brief  Where a callback was registered.
+        ///
+        struct site
+        {
+            std::string description;
+            std::string message;
+            std::string file;
+            size_t line;
+        };
+
+        ///
+        /// \brief  Aggregated measurements of one site.
+        ///
+        struct statistics
+        {
+            site_t id;
+            std::uint64_t calls;
+            std::chrono::nanoseconds total;
+
+            ///
+            /// \brief  The 99th percentile of the time per call, rounded up
+            ///         to the histogram bucket, so accurate to within a
+            ///         quarter of its value.
+            ///
+            std::chrono::nanoseconds p99;
+        };
+
+    private:
+        ///
+        /// \brief  Logarithmic histogram buckets, four per power of two.
+        ///
+        constexpr static size_t buckets = 4 * 63;
+
+        struct counters
+        {
+            std::uint64_t calls = 0;
+            std::uint64_t total = 0;
+            std::array<std::uint64_t, buckets> histogram = {};
+
+            void merge(const counters &o);
+
+            statistics summarize(site_t id) const;
+        };
+
+        ///
+        /// \brief  The counters owned by one thread, indexed by site.
+        ///
+        struct thread_counters
+        {
+            std::vector<counters> sites;
+
+            ~thread_counters();
+        };
+
+        std::atomic<bool> enabled_;
+
+        mutable std::mutex mutex_;
+
+        std::vector<site> sites_;
+
+        std::map<std::tuple<std::string, std::string, std::string, size_t>, site_t> index_;
+
+        ///
+        /// \brief  The counters of all live threads that recorded calls.
+        ///
+        std::vector<thread_counters *> threads_;
+
+        ///
+        /// \brief  Counters of threads that exited before being aggregated.
+        ///
+        std::vector<counters> retired_;
+
+        std::vector<counters> step_;
+
+        std::vector<counters> totals_;
+
+        profiler();
+
+        thread_counters &local();
+
+        void retire(thread_counters &t);
+
+    public:
+        profiler(const profiler &) = delete;
+
+        profiler &operator = (const profiler &) = delete;
+
+        static profiler &instance();
+
+        ///
+        /// \brief  The histogram bucket for a duration in nanoseconds.
+        ///
+        static size_t bucket(std::uint64_t nanoseconds);
+
+        ///
+        /// \brief  The largest duration in nanoseconds that falls in
+        ///         `bucket`.
+        ///
+        static std::uint64_t bucket_upper(size_t bucket);
+
+        void enable(bool enabled = true)
+        {
+            enabled_.store(enabled, std::memory_order_relaxed);
+        }
+
+        bool enabled() const
+        {
+            return enabled_.load(std::memory_order_relaxed);
+        }
+
+        ///
+        /// \brief  Returns the identifier of the site, registering it if it
+        ///         was not seen before.
+        ///
+        site_t register_site( const std::string &description
+                            , const std::string &message
+                            , const std::string &file
+                            , size_t line);
+
+        ///
+        /// \brief  Records one call on the calling thread.
+        ///
+        void record(site_t id, std::chrono::nanoseconds duration)
+        {
+            auto &local_ = local().sites;
+            if(local_.size() <= id) {
+                local_.resize(id + 1);
+            }
+            auto &c = local_[id];
+            ++c.calls;
+            auto nanoseconds_ = std::uint64_t(std::max<std::int64_t>(0, duration.count()));
+            c.total += nanoseconds_;
+            ++c.histogram[bucket(nanoseconds_)];
+        }
+
+        ///
+        /// \brief  Merges the counters of all threads, which become the
+        ///         statistics of the last step and are added to the totals.
+        ///
+        /// \details    Must not be called while callbacks are running.
+        ///
+        void aggregate();
+
+        ///
+        /// \brief  Discards all measurements, but keeps the sites.
+        ///
+        void reset();
+
+        ///
+        /// \brief  Statistics of the sites called in the last aggregated step
+        ///
+        std::vector<statistics> last_step() const;
+
+        ///
+        /// \brief  Statistics of all sites called since the last reset
+        ///
+        std::vector<statistics> totals() const;
+
+        ///
+        /// \brief  Where the site was registered.
+        ///
+        site where(site_t id) const;
+
+        ///
+        /// \brief  Writes the totals as comma separated values, one line per
+        ///         site, sorted by descending total time.
+        ///
+        void write_report(std::ostream &stream) const;
+    };
+}  // namespace esl::computation
+
+#endif  // ESL_COMPUTATION_PROFILER_HPP
@@ -0,0 +1,182 @@
+/// \file   random.hpp
+///
+/// \brief  Counter-based random number streams
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_COMPUTATION_RANDOM_HPP
+#define ESL_COMPUTATION_RANDOM_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+
+namespace esl::computation {
+
+    ///
+    /// \brief  A stream of random numbers from the Philox4x32-10 counter-based
+    ///         generator (Salmon et al., "Parallel random numbers: as easy as
+    ///         1, 2, 3", 2011).
+    ///
+    /// \details    Every output is a function of the key and a counter only.
+    ///             The model keys a stream by the sample, the agent, the time
+    ///             point and the round, so the numbers an agent draws do not
+    ///             depend on the number of threads or processes, or on the
+    ///             order in which agents run. Creating a stream costs a few
+    ///             integer operations and does not allocate.
+    ///
+    ///             Satisfies UniformRandomBitGenerator, so it can be used
+    ///             with the distributions in <random>.
+    ///
+    class random_stream
+    {
+    public:
+        typedef std::uint32_t result_type;
+
+        typedef std::array<std::uint32_t, 4> counter_t;
+
+        typedef std::array<std::uint32_t, 2> key_t;
+
+    private:
+        key_t key_          = {0, 0};
+
+        ///
+        /// \brief  The counter of the next block. The first word counts
+        ///         blocks within the stream, the others hold the round and
+        ///         time point the stream was created for.
+        ///
+        counter_t counter_  = {0, 0, 0, 0};
+
+        counter_t buffer_   = {0, 0, 0, 0};
+
+        unsigned int used_  = 4;
+
+        constexpr static std::uint64_t mix(std::uint64_t x)
+        {
+            // splitmix64 finaliser
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30u)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27u)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31u);
+        }
+
+    public:
+        ///
+        /// \brief  A stream with key and counter zero.
+        ///
+        random_stream() = default;
+
+        ///
+        /// \param sample   The model's sample
+        /// \param entity   Stable number of the entity drawing numbers, for
+        ///                 example the hash of its identity
+        /// \param time     The time point
+        /// \param round    The round within the time step
+        ///
+        random_stream( std::uint64_t sample
+                     , std::uint64_t entity
+                     , std::uint64_t time
+                     , std::uint32_t round = 0)
+        {
+            auto key_word_ = mix(entity ^ mix(sample));
+            key_     = {std::uint32_t(key_word_), std::uint32_t(key_word_ >> 32u)};
+            counter_ = {0, round, std::uint32_t(time), std::uint32_t(time >> 32u)};
+        }
+
+        ///
+        /// \brief  The Philox4x32-10 bijection of the counter under the key.
+        ///
+        constexpr static counter_t block(counter_t counter, key_t key)
+        {
+            for(unsigned int r = 0; r < 10; ++r) {
+                if(0 < r) {
+                    key[0] += 0x9E3779B9u;
+                    key[1] += 0xBB67AE85u;
+                }
+                std::uint64_t product0_ = std::uint64_t(0xD2511F53u) * counter[0];
+                std::uint64_t product1_ = std::uint64_t(0xCD9E8D57u) * counter[2];
+                counter = { std::uint32_t(product1_ >> 32u) ^ counter[1] ^ key[0]
+                          , std::uint32_t(product1_)
+                          , std::uint32_t(product0_ >> 32u) ^ counter[3] ^ key[1]
+                          , std::uint32_t(product0_)
+                          };
+            }
+            return counter;
+        }
+
+        constexpr static result_type min()
+        {
+            return 0;
+        }
+
+        constexpr static result_type max()
+        {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        result_type operator () ()
+        {
+            if(4 <= used_) {
+                buffer_ = block(counter_, key_);
+                ++counter_[0];
+                used_ = 0;
+            }
+            return buffer_[used_++];
+        }
+
+        ///
+        /// \return A uniformly distributed 64-bit integer
+        ///
+        std::uint64_t next64()
+        {
+            std::uint64_t high_ = (*this)();
+            return (high_ << 32u) | (*this)();
+        }
+
+        ///
+        /// \return A uniformly distributed number in [0, 1), with 53 bits of
+        ///         precision
+        ///
+        double uniform()
+        {
+            return double(next64() >> 11u) * 0x1.0p-53;
+        }
+
+        ///
+        /// \brief  Skips `n` outputs.
+        ///
+        void discard(unsigned long long n)
+        {
+            for(; 0 < n && used_ < 4; --n) {
+                ++used_;
+            }
+            counter_[0] += std::uint32_t(n / 4);
+            if(0 < n % 4) {
+                (*this)();
+                used_ += unsigned(n % 4) - 1;
+            }
+        }
+    };
+
+}  // namespace esl::computation
+
+#endif  // ESL_COMPUTATION_RANDOM_HPP
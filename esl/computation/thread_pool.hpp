@@ -28,8 +28,11 @@
 
 
 #include <esl/computation/blocking_queue.hpp>
+#include <chrono>
+#include <exception>
 #include <functional>
 #include <future>
+#include <type_traits>
 
 
 namespace esl::computation {
@@ -61,6 +64,13 @@ namespace esl::computation {
         ///
         constexpr static double load_factor = 2.;
 
+        ///
+        /// \brief  How long the thread calling `fork_join` with a poll
+        ///         function sleeps when there is nothing to do.
+        ///
+        constexpr static std::chrono::microseconds poll_interval =
+            std::chrono::microseconds(20);
+
         const unsigned int threads;
 
         explicit thread_pool(unsigned int threads = std::thread::hardware_concurrency())
@@ -176,6 +186,119 @@ namespace esl::computation {
 
             return result_;
         }
+
+        ///
+        /// \brief  Calls `f(t)` for every task index `0 <= t < tasks` on the
+        ///         workers of the pool, and blocks until all tasks completed.
+        ///
+        /// \details    Task indices are claimed from a shared counter, so that
+        ///             the closure put in the queues only captures a single
+        ///             pointer, and fits in the small object buffer of
+        ///             `std::function`. The first exception thrown by a task is
+        ///             rethrown in the calling thread.
+        ///
+        /// \tparam function_t_ Callable with signature `void(unsigned int)`
+        /// \param tasks        Number of tasks
+        /// \param f            Task function
+        template<typename function_t_>
+        void fork_join(unsigned int tasks, function_t_ &&f)
+        {
+            fork_join(tasks, std::forward<function_t_>(f), nullptr);
+        }
+
+        ///
+        /// \brief  As `fork_join(tasks, f)`, but the calling thread calls
+        ///         `poll()` while it waits for the workers, for example to
+        ///         make progress on communication that only it may do.
+        ///
+        /// \details    When `poll` returns false, there was nothing to do,
+        ///             and the calling thread sleeps until the workers are
+        ///             done or `poll_interval` has passed. When `poll` throws,
+        ///             it is not called again, and the first exception (of
+        ///             `poll` or a task) is rethrown after all tasks completed.
+        ///
+        /// \tparam poll_t_     Callable with signature `bool()`, or nullptr
+        ///                     to block until the workers are done
+        template<typename function_t_, typename poll_t_>
+        void fork_join(unsigned int tasks, function_t_ &&f, poll_t_ &&poll)
+        {
+            if(0 == tasks) {
+                return;
+            }
+
+            struct join_state
+            {
+                function_t_ &function;
+                std::atomic<unsigned int> next;
+                unsigned int remaining;
+                std::exception_ptr error;
+                std::mutex mutex;
+                std::condition_variable done;
+            } state_ {f, {0}, tasks, nullptr, {}, {}};
+
+            auto *pointer_ = &state_;
+            std::function<void(void)> work_ = [pointer_]()
+            {
+                auto task_ = pointer_->next++;
+                std::exception_ptr error_;
+                try {
+                    pointer_->function(task_);
+                } catch(...) {
+                    error_ = std::current_exception();
+                }
+
+                std::unique_lock lock_(pointer_->mutex);
+                if(error_ && !pointer_->error) {
+                    pointer_->error = error_;
+                }
+                if(0 == --pointer_->remaining) {
+                    pointer_->done.notify_one();
+                }
+            };
+
+            for(unsigned int t = 0; t < tasks; ++t) {
+                unsigned int i = index_++;
+                if(!queues_[i % threads].try_push(work_)) {
+                    queues_[i % threads].push(work_);
+                }
+            }
+
+            std::unique_lock lock_(state_.mutex);
+            auto joined_ = [&state_]() {
+                return 0 == state_.remaining;
+            };
+            if constexpr(std::is_null_pointer_v<std::decay_t<poll_t_>>) {
+                state_.done.wait(lock_, joined_);
+            }else{
+                // once `poll` threw, the workers may still be using
+                // `state_`, so we stop polling but keep waiting for them
+                bool polling_ = true;
+                while(polling_ && !joined_()) {
+                    lock_.unlock();
+                    bool progress_ = false;
+                    std::exception_ptr error_;
+                    try {
+                        progress_ = poll();
+                    } catch(...) {
+                        error_ = std::current_exception();
+                    }
+                    lock_.lock();
+                    if(error_) {
+                        if(!state_.error) {
+                            state_.error = error_;
+                        }
+                        polling_ = false;
+                    } else if(!progress_) {
+                        state_.done.wait_for(lock_, poll_interval, joined_);
+                    }
+                }
+                state_.done.wait(lock_, joined_);
+            }
+
+            if(state_.error) {
+                std::rethrow_exception(state_.error);
+            }
+        }
     };
 
 }//esl::computation
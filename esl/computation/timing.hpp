@@ -44,27 +44,57 @@ namespace esl::computation {
                   >= 1000);
 
     ///
-    ///
+    /// \brief  Time spent computing a single agent, as measured by the model.
     ///
     struct agent_timing
     {
-        std::chrono::milliseconds messaging;
-        std::chrono::milliseconds acting;
+        ///
+        /// \brief  Total time spent processing messages
+        ///
+        std::chrono::nanoseconds messaging = std::chrono::nanoseconds(0);
+
+        ///
+        /// \brief  Total time spent acting
+        ///
+        std::chrono::nanoseconds acting = std::chrono::nanoseconds(0);
+
+        ///
+        /// \brief  Moving average of the time the agent takes per round,
+        ///         used by schedulers as a hint of the agent's cost.
+        ///
+        std::chrono::nanoseconds estimate = std::chrono::nanoseconds(0);
+
+        ///
+        /// \brief  Adds the measurement of one round.
+        ///
+        void record(std::chrono::nanoseconds messaging_round,
+                    std::chrono::nanoseconds acting_round)
+        {
+            messaging += messaging_round;
+            acting += acting_round;
+            // exponential moving average with weight 1/4 on the latest round
+            estimate += (messaging_round + acting_round - estimate) / 4;
+        }
 
         template<class archive_t>
         void serialize(archive_t &archive, const unsigned int version)
         {
             (void)version;
 
-            boost::serialization::make_nvp(
+            archive &boost::serialization::make_nvp(
                 "messaging",
                 boost::serialization::make_binary_object(&messaging,
                                                          sizeof(messaging)));
 
-            boost::serialization::make_nvp(
+            archive &boost::serialization::make_nvp(
                 "acting",
                 boost::serialization::make_binary_object(&acting,
                                                          sizeof(acting)));
+
+            archive &boost::serialization::make_nvp(
+                "estimate",
+                boost::serialization::make_binary_object(&estimate,
+                                                         sizeof(estimate)));
         }
     };
 }  // namespace esl::computation
@@ -37,7 +37,7 @@ namespace esl {
     template<std::uint64_t code_integer_>
     struct type_code
     {
-        static const std::uint64_t code = code_integer_;
+        constexpr static std::uint64_t code = code_integer_;
 
         ///
         /// \brief  Vestigial serialization, so that inheriting classes can
@@ -0,0 +1,108 @@
+/// \file   work_stealing.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <esl/computation/work_stealing.hpp>
+
+#include <algorithm>
+
+
+namespace esl::computation {
+
+    work_stealing::work_stealing(unsigned int workers)
+    : deques_(std::max(1u, workers))
+    {
+
+    }
+
+    void work_stealing::assign(unsigned int worker, task_t begin, task_t end)
+    {
+        deques_[worker].bounds.store(pack(begin, end), std::memory_order_relaxed);
+    }
+
+    void work_stealing::assign(task_t tasks)
+    {
+        auto workers_ = task_t(deques_.size());
+        task_t chunk_ = (tasks + workers_ - 1) / workers_;
+        for(task_t w = 0; w < workers_; ++w) {
+            task_t begin_ = std::min(tasks, w * chunk_);
+            assign(w, begin_, std::min(tasks, begin_ + chunk_));
+        }
+    }
+
+    bool work_stealing::pop(unsigned int worker, task_t &task)
+    {
+        auto &bounds_ = deques_[worker].bounds;
+        auto current_ = bounds_.load(std::memory_order_acquire);
+        do {
+            if(begin(current_) >= end(current_)) {
+                return false;
+            }
+        } while(!bounds_.compare_exchange_weak(
+            current_, pack(begin(current_) + 1, end(current_)),
+            std::memory_order_acq_rel, std::memory_order_acquire));
+
+        task = begin(current_);
+        return true;
+    }
+
+    bool work_stealing::steal(unsigned int victim, unsigned int thief)
+    {
+        auto &bounds_ = deques_[victim].bounds;
+        auto current_ = bounds_.load(std::memory_order_acquire);
+        task_t middle_;
+        do {
+            if(begin(current_) >= end(current_)) {
+                return false;
+            }
+            // the thief takes the larger half, so that single tasks can
+            // be stolen too
+            middle_ = end(current_)
+                    - (end(current_) - begin(current_) + 1) / 2;
+        } while(!bounds_.compare_exchange_weak(
+            current_, pack(begin(current_), middle_),
+            std::memory_order_acq_rel, std::memory_order_acquire));
+
+        // the thief's range is empty, so that no other worker modifies it
+        deques_[thief].bounds.store(pack(middle_, end(current_)),
+                                    std::memory_order_release);
+        return true;
+    }
+
+    bool work_stealing::next(unsigned int worker, task_t &task)
+    {
+        while(!pop(worker, task)) {
+            bool stolen_ = false;
+            for(unsigned int n = 1; n < deques_.size() && !stolen_; ++n) {
+                stolen_ = steal((worker + n) % deques_.size(), worker);
+            }
+            // all ranges were empty when visited. Ranges only shrink
+            // or move to an owner that will run them, so we are done
+            if(!stolen_) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}  // namespace esl::computation
@@ -0,0 +1,133 @@
+/// \file   work_stealing.hpp
+///
+/// \brief  Lock-free distribution of task indices over workers, where idle
+///         workers steal work from busy workers.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_COMPUTATION_WORK_STEALING_HPP
+#define ESL_COMPUTATION_WORK_STEALING_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+
+namespace esl::computation {
+
+    ///
+    /// \brief  Assigns every worker a contiguous range of task indices, its
+    ///         deque. Workers take tasks from the front of their own range,
+    ///         and when it is exhausted they steal the back half of the range
+    ///         of another worker.
+    ///
+    /// \details    Each range is packed into a single 64-bit word, so that
+    ///             both taking and stealing are a single compare-and-swap and
+    ///             no memory is allocated after construction.
+    ///
+    class work_stealing
+    {
+    public:
+        ///
+        /// \brief  Task indices are limited to 32 bits, so that a range fits
+        ///         in one atomic word.
+        ///
+        typedef std::uint32_t task_t;
+
+    private:
+        ///
+        /// \brief  The range [begin, end) of a single worker, aligned to
+        ///         separate cache lines.
+        ///
+        struct alignas(64) deque_t
+        {
+            std::atomic<std::uint64_t> bounds = 0;
+        };
+
+        std::vector<deque_t> deques_;
+
+        constexpr static std::uint64_t pack(task_t begin, task_t end)
+        {
+            return (std::uint64_t(begin) << 32u) | end;
+        }
+
+        constexpr static task_t begin(std::uint64_t bounds)
+        {
+            return task_t(bounds >> 32u);
+        }
+
+        constexpr static task_t end(std::uint64_t bounds)
+        {
+            return task_t(bounds);
+        }
+
+        ///
+        /// \brief  Takes the first task from the worker's own range.
+        ///
+        bool pop(unsigned int worker, task_t &task);
+
+        ///
+        /// \brief  Moves the back half of the victim's range to the thief,
+        ///         whose own range must be empty.
+        ///
+        bool steal(unsigned int victim, unsigned int thief);
+
+    public:
+        ///
+        /// \param workers  The number of workers taking part
+        ///
+        explicit work_stealing(unsigned int workers);
+
+        work_stealing(const work_stealing &) = delete;
+
+        ///
+        /// \return The number of workers
+        ///
+        [[nodiscard]] unsigned int workers() const
+        {
+            return static_cast<unsigned int>(deques_.size());
+        }
+
+        ///
+        /// \brief  Sets the initial range of a worker. Must not be called
+        ///         while workers are running.
+        ///
+        void assign(unsigned int worker, task_t begin, task_t end);
+
+        ///
+        /// \brief  Divides [0, tasks) into equally sized ranges.
+        ///
+        void assign(task_t tasks);
+
+        ///
+        /// \brief  Obtains the next task for the worker, first from its own
+        ///         range and otherwise by stealing.
+        ///
+        /// \param worker   The worker asking for work
+        /// \param task     Set to the task index on success
+        /// \return `false` when no work is left in any range
+        ///
+        bool next(unsigned int worker, task_t &task);
+    };
+
+}  // namespace esl::computation
+
+#endif  // ESL_COMPUTATION_WORK_STEALING_HPP
@@ -27,11 +27,15 @@
 
 #include <string>
 #include <iostream>
+#include <sstream>
 #include <vector>
 
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 #include <boost/serialization/vector.hpp>
 
 #include <esl/data/output_base.hpp>
+#include <esl/data/serialization.hpp>
 #include <esl/simulation/time.hpp>
 
 #include <esl/computation/allocator.hpp>
@@ -85,6 +89,25 @@ namespace esl::data {
             }
         }
 
+        std::string encode_values() const override
+        {
+            std::ostringstream stream_(std::ios::binary);
+            {
+                boost::archive::binary_oarchive archive_(
+                    stream_, boost::archive::no_header);
+                archive_ << values;
+            }
+            return stream_.str();
+        }
+
+        void decode_values(const std::string &encoded) override
+        {
+            std::istringstream stream_(encoded, std::ios::binary);
+            boost::archive::binary_iarchive archive_(
+                stream_, boost::archive::no_header);
+            archive_ >> values;
+        }
+
         template<class archive_t>
         void serialize(archive_t &archive, const unsigned int version)
         {
@@ -105,6 +105,24 @@ namespace esl::data {
         ///
         virtual ~output_base() = default;
 
+        ///
+        /// \brief  The values observed so far, encoded, so that they can be
+        ///         saved through a pointer to the base class.
+        ///
+        virtual std::string encode_values() const
+        {
+            return std::string();
+        }
+
+        ///
+        /// \brief  Replaces the values by those encoded by `encode_values`
+        ///         of an output of the same type.
+        ///
+        virtual void decode_values(const std::string &encoded)
+        {
+            (void)encoded;
+        }
+
         template<class archive_t>
         void serialize(archive_t &archive, const unsigned int version)
         {
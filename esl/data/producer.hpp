@@ -26,6 +26,10 @@
 #define ESL_DATA_PRODUCER_HPP
 
 #include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <boost/serialization/string.hpp>
 
 //#include <boost/serialization/unordered_map.hpp>
 
@@ -64,6 +68,10 @@ namespace esl::data {
             return output_;
         }
 
+        ///
+        /// \details    Outputs are created by the producer's constructor, so
+        ///             only their values are saved, by name.
+        ///
         template<typename archive_t>
         void save(archive_t &archive, const unsigned int version) const
         {
@@ -71,10 +79,10 @@ namespace esl::data {
             size_t size_ = outputs.size();
             archive <<BOOST_SERIALIZATION_NVP(size_);
 
-            for(auto [key_,v] : outputs){
-                output_base &value_ = *v;
+            for(const auto &[key_, value_] : outputs){
+                std::string values_ = value_->encode_values();
                 archive << boost::serialization::make_nvp("name", key_);
-                archive << boost::serialization::make_nvp<output_base>(key_.c_str(), value_);
+                archive << boost::serialization::make_nvp("values", values_);
             }
         }
 
@@ -87,11 +95,15 @@ namespace esl::data {
             archive >> BOOST_SERIALIZATION_NVP(size_);
 
             for(size_t i = 0; i < size_; ++i){
-                std::string  key_;
+                std::string key_;
+                std::string values_;
                 archive >> boost::serialization::make_nvp("name", key_);
-                output_base *value_ = nullptr;
-                archive >> boost::serialization::make_nvp(key_.c_str(), value_);
-                assert(value_);
+                archive >> boost::serialization::make_nvp("values", values_);
+                auto output_ = outputs.find(key_);
+                if(outputs.end() == output_){
+                    throw std::invalid_argument("output \"" + key_ + "\" not found (use create_output in the constructor)");
+                }
+                output_->second->decode_values(values_);
             }
         }
 
@@ -43,7 +43,7 @@ namespace esl::economics::finance {
             [this](std::shared_ptr<markets::walras::quote_message> m,
                    simulation::time_interval step, std::seed_seq &seed) {
                 (void) seed;
-                for(auto &[k, v] : m->proposed){
+                for(auto &[k, v] : *m->proposed){
                     assert(std::holds_alternative<price>(v.type));
                     auto p = std::make_pair(k, std::get<price>(v.type));
                     this->bond_prices.insert(std::move(p));
@@ -24,8 +24,16 @@
 ///
 #include <esl/economics/finance/dividend.hpp>
 
+#include <esl/interaction/message_codec.hpp>
+
 namespace esl::economics::finance {
 
+    static const bool dividend_announcement_registered_ =
+        interaction::message_codec::register_message<dividend_announcement_message>();
+
+    static const bool dividend_record_registered_ =
+        interaction::message_codec::register_message<dividend_record>();
+
     dividend_policy::dividend_policy(
         simulation::time_point announcement_date,
         simulation::time_point ex_dividend_date,
@@ -30,6 +30,9 @@
 #include <tuple>
 #include <utility>
 
+#include <boost/serialization/map.hpp>
+
+#include <esl/data/serialization.hpp>
 #include <esl/economics/currencies.hpp>
 #include <esl/economics/finance/share_class.hpp>
 #include <esl/economics/price.hpp>
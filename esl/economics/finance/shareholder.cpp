@@ -66,7 +66,7 @@ namespace esl::economics::finance {
             [this](std::shared_ptr<markets::walras::quote_message> m,
                    simulation::time_interval step, std::seed_seq &seed) {
                 (void) seed;
-                for(auto &[k, v] : m->proposed){
+                for(auto &[k, v] : *m->proposed){
                     assert(std::holds_alternative<price>(v.type));
 
                     auto i = prices.find(k);
@@ -23,3 +23,11 @@
 ///             requirements in CITATION.cff
 ///
 #include "order.hpp"
+
+#include <esl/interaction/message_codec.hpp>
+
+
+namespace esl::economics::markets::impact_function {
+    static const bool order_message_registered_ =
+        interaction::message_codec::register_message<order_message>();
+}  // namespace esl::economics::markets::impact_function
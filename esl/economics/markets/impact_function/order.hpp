@@ -28,6 +28,10 @@
 
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/utility.hpp>
 
 #include <esl/economics/markets/order_message.hpp>
 
@@ -46,8 +50,8 @@ namespace esl::economics::markets::impact_function {
         law::property_map<std::pair<std::uint64_t, side_t>> volumes;
 
 
-        order_message( identity<agent> sender
-                      , identity<agent> recipient
+        order_message( identity<agent> sender       = identity<agent>()
+                      , identity<agent> recipient    = identity<agent>()
                       , simulation::time_point sent     = simulation::time_point()
                       , simulation::time_point received = simulation::time_point())
         : markets::order_message<order_message, interaction::library_message_code<0x00B2U>()>
@@ -63,6 +67,8 @@ namespace esl::economics::markets::impact_function {
             typedef markets::order_message<order_message, interaction::library_message_code<0x00B2U>()>
                 order_message_type;
             archive &BOOST_SERIALIZATION_BASE_OBJECT_NVP(order_message_type);
+            archive &BOOST_SERIALIZATION_NVP(side);
+            archive &BOOST_SERIALIZATION_NVP(volumes);
         }
     };
 }
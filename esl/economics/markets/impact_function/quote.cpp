@@ -23,3 +23,11 @@
 ///             requirements in CITATION.cff
 ///
 #include "quote.hpp"
+
+#include <esl/interaction/message_codec.hpp>
+
+
+namespace esl::economics::markets::impact_function {
+    static const bool quote_message_registered_ =
+        interaction::message_codec::register_message<quote_message>();
+}  // namespace esl::economics::markets::impact_function
@@ -40,6 +40,7 @@ namespace esl::economics::markets::order_book {
         , cancel
         , match
         , placement
+        , resize    // the order book changed the range of accepted limits
         } state;
 
         ///
@@ -153,6 +154,9 @@ namespace esl::economics::markets::order_book {
             case placement:
                 stream << "placement";
                 break;
+            case resize:
+                stream << "resize";
+                break;
             default:
                 throw esl::exception("invalid execution_report state");
             }
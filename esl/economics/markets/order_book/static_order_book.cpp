@@ -23,3 +23,8 @@
 ///             requirements in CITATION.cff
 ///
 #include "static_order_book.hpp"
+
+
+namespace esl::economics::markets::order_book {
+    template class basic_static_order_book<price, 1>;
+}
@@ -26,31 +26,96 @@
 #define ESL_STATIC_ORDER_BOOK_HPP
 
 #include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <variant>
 
 #include <esl/economics/markets/order_book/basic_book.hpp>
+#include <esl/economics/price.hpp>
 #include <esl/computation/block_pool.hpp>
+#include <esl/computation/hierarchical_bitmap.hpp>
 #include <esl/data/log.hpp>
 
 
 namespace esl::economics::markets::order_book {
 
-        class static_order_book
+        ///
+        /// \brief  Converts a quote type to and from an integer number of its
+        ///         smallest units, so that order books can compute price
+        ///         levels without floating point arithmetic.
+        ///
+        /// \tparam price_t_    The type held by the quote
+        template<typename price_t_>
+        struct quote_units;
+
+        ///
+        /// \brief  Prices are whole numbers of the minor currency unit, e.g.
+        ///         cents for USD
+        ///
+        template<>
+        struct quote_units<price>
+        {
+            static constexpr std::int64_t units(const price &p)
+            {
+                return p.value;
+            }
+
+            static constexpr price from_units(std::int64_t units, const price &similar)
+            {
+                return price(units, similar.valuation);
+            }
+
+            ///
+            /// \brief  Whether the units of both prices are comparable
+            ///
+            static constexpr bool similar(const price &a, const price &b)
+            {
+                return a.valuation == b.valuation;
+            }
+        };
+
+        ///
+        /// \brief  Limit order book with a price level for every tick between
+        ///         a minimum and maximum quote, and a growable memory pool
+        ///         for resting orders.
+        ///
+        /// \details    Quotes are converted once on entry to an integer number
+        ///             of ticks above the minimum quote, so that finding the
+        ///             price level of an order is a subtraction and matching
+        ///             uses no floating point arithmetic.
+        ///
+        /// \tparam price_t_    The type of quote accepted by the book
+        /// \tparam tick_size_  The tick size in the smallest units of the
+        ///                     quote, e.g. a tick size of 5 for prices in USD
+        ///                     means prices are multiples of 5 cents.
+        template< typename price_t_ = price
+                , std::int64_t tick_size_ = 1
+                >
+        class basic_static_order_book
         : public basic_book
         {
+            static_assert(0 < tick_size_, "tick size must be strictly positive");
+
         public:
             typedef std::uint32_t quantity_t_;
 
+            ///
+            /// \brief  Used to identify the price level, as the number of
+            ///         ticks above the minimum quote
+            ///
+            typedef std::int64_t limit;
+
+            ///
+            /// \brief  The tick size in the smallest units of the quote
+            ///
+            constexpr static const std::int64_t tick_size = tick_size_;
+
             ///
             /// \brief  An abbreviated record for orders in the order book.
             ///
             ///
             struct record
             {
-                ///
-                /// \brief
-                ///
-                quote limit;
-
                 ///
                 /// \brief  Order quantity remaining
                 ///
@@ -65,6 +130,25 @@ namespace esl::economics::markets::order_book {
                 /// \brief  Pointer to the next block in the order-queue
                 ///
                 computation::block_pool::block<record> *successor;
+
+                ///
+                /// \brief  Pointer to the previous block in the order-queue,
+                ///         so that cancelled orders are unlinked in constant
+                ///         time
+                ///
+                computation::block_pool::block<record> *predecessor;
+
+                ///
+                /// \brief  Tick of the order's price level, counted from the
+                ///         book's origin so that it stays valid when the
+                ///         window of levels moves
+                ///
+                limit level;
+
+                ///
+                /// \brief  Whether the order rests on the buy or sell side
+                ///
+                limit_order_message::side_t side;
             };
 
             typedef computation::block_pool::static_block_pool<record> pool_t;
@@ -77,8 +161,6 @@ namespace esl::economics::markets::order_book {
         public:
             typedef typename pool_t::index index;
 
-            typedef std::int64_t limit;
-
             ///
             /// \brief  Used by the data-structure index the memory pool.
             ///
@@ -100,6 +182,18 @@ namespace esl::economics::markets::order_book {
             ///
             std::vector<limit_type> limits_;
 
+            ///
+            /// \brief  One bit per entry in `limits_`, set when the level has
+            ///         resting orders, to find the next best level without
+            ///         scanning empty levels.
+            ///
+            /// \details    As the book is never crossed after matching, the
+            ///             occupied levels below the best bid are bids and
+            ///             those above the best ask are asks, so one bitmap
+            ///             serves both sides.
+            ///
+            computation::hierarchical_bitmap occupied_;
+
         private:
             ///
             /// \brief  Limit prices below the minimum price or above the maximum
@@ -108,6 +202,23 @@ namespace esl::economics::markets::order_book {
             ///
             mathematics::interval<quote> valid_limits;
 
+            ///
+            /// \brief  Tick of `limits_.front()`, counted from the origin
+            ///
+            limit base_ = 0;
+
+            ///
+            /// \brief  The minimum quote, used to construct quotes with the
+            ///         same currency and lot size from price levels
+            ///
+            price_t_ similar_;
+
+            ///
+            /// \brief  The minimum quote at construction in its smallest
+            ///         units, from which ticks are counted
+            ///
+            std::int64_t origin_;
+
             ///
             /// \brief  pointer into the `limits_` datastructure to the best
             ///         bid offer. Takes `nullptr` value when buy side of the
@@ -124,129 +235,301 @@ namespace esl::economics::markets::order_book {
             limit_type *best_ask_;
 
             ///
-            /// \brief  Used to translate quotes to a position in the data
-            ///         structure.
-            /// \returns    Success is communicated by the return value `true`.
+            /// \brief  Moves the best bid down to the next level with
+            ///         resting orders, or to `nullptr` if there are none
             ///
-            std::function<bool(const mathematics::interval<quote> &limits, const quote &quote, limit &out_limit)> encode;
+            void retreat_best_bid()
+            {
+                auto level_ = occupied_.previous(best_bid_ - &limits_[0]);
+                best_bid_ = (computation::hierarchical_bitmap::npos == level_)
+                            ? nullptr : &limits_[level_];
+            }
 
             ///
-            /// \brief  Used to get the associated quote from a position in the
-            ///             data-structure.
+            /// \brief  Moves the best ask up to the next level with resting
+            ///         orders, or to `nullptr` if there are none
             ///
-            std::function<quote(const mathematics::interval<quote> &limits, const limit &limit)> decode;
+            void retreat_best_ask()
+            {
+                auto level_ = occupied_.next(best_ask_ - &limits_[0]);
+                best_ask_ = (computation::hierarchical_bitmap::npos == level_)
+                            ? nullptr : &limits_[level_];
+            }
 
             ///
-            /// \brief  Computes the required number of tick levels
-            /// \return
-            size_t span(size_t lot, size_t ticks) const
+            /// \brief  Removes a resting order from the queue at its price
+            ///         level, and moves the best bid or ask away from the level
+            ///         if it is emptied. The block stays in the pool.
+            ///
+            /// \param order
+            void unlink(record_pointer order)
             {
-                return static_cast<size_t>(
-                    (double(valid_limits.upper) - double(valid_limits.lower)) * lot
-                    * ticks + 1);
+                auto &record_ = order->data;
+                auto index_ = record_.level - base_;
+                limit_type *level_ = &limits_[index_];
+
+                if(record_.predecessor){
+                    record_.predecessor->data.successor = record_.successor;
+                }else{
+                    level_->first = record_.successor;
+                }
+
+                if(record_.successor){
+                    record_.successor->data.predecessor = record_.predecessor;
+                }else{
+                    level_->second = record_.predecessor;
+                }
+
+                if(level_->first){
+                    return;
+                }
+                occupied_.reset(index_);
+
+                if(limit_order_message::buy == record_.side
+                   && level_ == best_bid_){
+                    LOG(trace) << decode(index_) << " bid level depleted" << std::endl;
+                    retreat_best_bid();
+                }else if(limit_order_message::sell == record_.side
+                         && level_ == best_ask_){
+                    LOG(trace) << decode(index_) << " ask level depleted" << std::endl;
+                    retreat_best_ask();
+                }
             }
 
-        public:
             ///
-            /// \brief      Number of ticks in the currency unit.
-            /// \example    When prices are quoted in USD, and to a precision of
-            ///             cents, the number of ticks per currency unit is 100.
+            /// \brief  The price at a level in `limits_`, in the units of the
+            ///         quote type
             ///
-            std::uint32_t ticks;
+            [[nodiscard]] price_t_ level_price(limit level) const
+            {
+                return quote_units<price_t_>::from_units(
+                    origin_ + (base_ + level) * tick_size_, similar_);
+            }
 
             ///
-            /// \brief  The default encoding function
+            /// \brief  Translates a quote to a tick counted from the origin,
+            ///         regardless of the current window of levels
             ///
-            /// \param q
-            /// \param out_limit
-            /// \return
-            /*C++20 constexpr*/  bool default_encode(const mathematics::interval<quote> &limits, const quote &q, limit &out_limit)
+            /// \returns    false for quotes of another type, currency or lot
+            ///             size than the minimum quote, or in between ticks
+            [[nodiscard]] bool to_ticks(const quote &q, limit &out_tick) const
             {
-                if(limits.lower > q || limits.upper < q){
+                const auto *p = std::get_if<price_t_>(&q.type);
+                if(!p || q.lot != valid_limits.lower.lot
+                   || !quote_units<price_t_>::similar(*p, similar_)){
                     return false;
                 }
-                out_limit = static_cast<limit>(
-                    (double(q) - double(limits.lower))
-                    / (double(limits.upper) - double(limits.lower))
-                    * limits_.size()
-                );
+                auto offset_ = quote_units<price_t_>::units(*p) - origin_;
+                if(0 != offset_ % tick_size_){
+                    return false;
+                }
+                out_tick = offset_ / tick_size_;
                 return true;
             }
 
             ///
-            /// \brief  The default decoding function
+            /// \brief  Moves the window of levels to start at tick `base` and
+            ///         span `span` levels. Resting orders outside the new
+            ///         window are cancelled, the others keep their blocks
+            ///         and pool indices.
             ///
-            /// \param limit
-            /// \return
-            /*C++20 constexpr*/ quote default_decode(const mathematics::interval<quote> &limits, const limit &limit)
+            void relocate(limit base, std::size_t span)
+            {
+                auto npos_ = computation::hierarchical_bitmap::npos;
+                std::vector<limit_type> moved_(span, std::make_pair(nullptr, nullptr));
+                computation::hierarchical_bitmap occupied_moved_(span);
+                auto best_bid_index_ = npos_;
+                auto best_ask_index_ = npos_;
+
+                for(auto l = occupied_.next(0); npos_ != l; l = occupied_.next(l + 1)){
+                    auto tick_ = base_ + limit(l);
+                    if(tick_ < base || tick_ >= base + limit(span)){
+                        for(auto *o = limits_[l].first; o;){
+                            auto *successor_ = o->data.successor;
+                            reports.emplace_back(execution_report
+                                                     ( execution_report::cancel
+                                                     , o->data.side
+                                                     , o->data.quantity
+                                                     , o->index
+                                                     , decode(l)
+                                                     , o->data.owner
+                                                     ));
+                            pool_.erase(o->index);
+                            o = successor_;
+                        }
+                        continue;
+                    }
+
+                    auto index_ = std::size_t(tick_ - base);
+                    moved_[index_] = limits_[l];
+                    occupied_moved_.set(index_);
+                    // bids are below asks, so the last bid level is the best
+                    // bid and the first ask level the best ask
+                    if(limit_order_message::buy == limits_[l].first->data.side){
+                        best_bid_index_ = index_;
+                    }else if(npos_ == best_ask_index_){
+                        best_ask_index_ = index_;
+                    }
+                }
+
+                limits_.swap(moved_);
+                occupied_ = std::move(occupied_moved_);
+                base_ = base;
+                best_bid_ = npos_ == best_bid_index_ ? nullptr : &limits_[best_bid_index_];
+                best_ask_ = npos_ == best_ask_index_ ? nullptr : &limits_[best_ask_index_];
+                valid_limits = mathematics::interval<quote>(decode(0), decode(limit(span) - 1));
+
+                // the report carries the new minimum quote and the number
+                // of levels
+                reports.emplace_back(execution_report
+                                         ( execution_report::resize
+                                         , limit_order_message::buy
+                                         , static_cast<std::uint32_t>(span)
+                                         , basic_book::direct_order
+                                         , valid_limits.lower
+                                         , identity<agent>()
+                                         ));
+            }
+
+            ///
+            /// \brief  Grows and moves the window of levels so that it
+            ///         contains the tick and all resting orders, centred on
+            ///         them with at least as many free levels as are occupied.
+            ///
+            /// \details    The number of levels doubles when it grows, so
+            ///             that the cost of moving is amortized over the ticks
+            ///             that prices moved.
+            ///
+            /// \returns    false, leaving the book unchanged, when this needs
+            ///             more than `maximum_levels` levels
+            [[nodiscard]] bool recentre(limit tick)
             {
-                auto reverse = (double(limit) * (double(valid_limits.upper) - double(valid_limits.lower))) * limits.lower.lot * limits.lower.lot;
-                auto intercept_ = double(valid_limits.lower) * limits.lower.lot * limits.lower.lot;
-                return quote( (reverse/ double(limits_.size()-1) +  intercept_) / limits.lower.lot, valid_limits.lower);
+                auto lowest_ = tick;
+                auto highest_ = tick;
+                if(!occupied_.empty()){
+                    lowest_ = std::min(lowest_, base_ + limit(occupied_.next(0)));
+                    highest_ = std::max(highest_, base_ + limit(occupied_.previous(limits_.size() - 1)));
+                }
+                // unsigned, so that ticks far apart do not overflow
+                auto distance_ = std::uint64_t(highest_) - std::uint64_t(lowest_);
+                if(maximum_levels / 2 <= distance_){
+                    LOG(trace) << "moving the order book to tick " << tick << " needs more than " << maximum_levels << " levels" << std::endl;
+                    return false;
+                }
+                auto span_ = limits_.size();
+                while(span_ < 2 * std::size_t(distance_ + 1)){
+                    span_ *= 2;
+                }
+                span_ = std::max(limits_.size(), std::min(span_, maximum_levels));
+                LOG(trace) << "moving the order book to " << span_ << " levels around tick " << tick << std::endl;
+                relocate(lowest_ + limit(distance_ / 2) - limit(span_ / 2), span_);
+                return true;
             }
 
+        public:
             ///
-            /// \brief
+            /// \brief  Translates a quote to a position in the data structure.
             ///
-            /// \details    The tick-size is set to the minimum lot size taken
-            ///             from the minimum and maximum quotes
+            /// \returns    Success is communicated by the return value `true`.
+            ///             Quotes of another type, currency or lot size than
+            ///             the minimum quote, outside the valid range, or in
+            ///             between ticks are rejected.
             ///
-            /// \param minimum
-            /// \param maximum
-            /// \param capacity
+            [[nodiscard]] bool encode(const quote &q, limit &out_limit) const
+            {
+                if(!to_ticks(q, out_limit)){
+                    return false;
+                }
+                out_limit -= base_;
+                return 0 <= out_limit
+                    && static_cast<std::uint64_t>(out_limit) < limits_.size();
+            }
+
+            ///
+            /// \brief  Gets the associated quote from a position in the
+            ///         data-structure.
+            ///
+            [[nodiscard]] quote decode(limit l) const
+            {
+                return quote(level_price(l), valid_limits.lower.lot);
+            }
+
             ///
-            static_order_book( const quote &minimum
-                , const quote &maximum
-                , size_t capacity = 128*1024
+            /// \param minimum  The lowest accepted quote
+            /// \param maximum  The highest accepted quote
+            /// \param capacity The number of resting orders allocated up
+            ///                 front. The pool grows beyond it in chunks,
+            ///                 without moving resting orders.
+            ///
+            basic_static_order_book( const quote &minimum
+                                   , const quote &maximum
+                                   , size_t capacity = 128*1024
             )
                 : basic_book( )
-                , pool_(capacity)
+                , pool_(capacity, true)
                 , valid_limits(minimum, maximum)
-                , ticks(std::min(minimum.lot, maximum.lot))
+                , similar_(std::get<price_t_>(minimum.type))
+                , origin_(quote_units<price_t_>::units(similar_))
             {
-
                 reports.reserve(32);
                 assert(!valid_limits.empty());
                 assert(minimum.lot == maximum.lot);
+                auto upper_ = quote_units<price_t_>::units(std::get<price_t_>(maximum.type));
                 // +1 because the maximum value is included
-                auto span_ = span(minimum.lot, ticks);
+                auto span_ = static_cast<size_t>((upper_ - origin_) / tick_size_ + 1);
                 // since nullptr is used in the logic of the datastructure,
                 //  we make sure to set this explicitly
                 limits_.resize(span_, std::make_pair(nullptr, nullptr));
+                occupied_.resize(span_);
 
-                best_bid_ = &limits_.front();
-                best_ask_ = &limits_.back();
+                best_bid_ = nullptr;
+                best_ask_ = nullptr;
+            }
 
-                encode = [&](const mathematics::interval<quote> &limits, const auto &q, auto &l) -> bool {
-                    return default_encode(limits, q, l);
-                };
+            ///
+            /// \brief  When set, orders outside the range of valid limits move
+            ///         and grow the range instead of being rejected.
+            ///
+            bool automatic_resize = false;
 
-                decode = [&](const mathematics::interval<quote> &limits, const auto &l) -> quote {
-                    return default_decode(limits, l);
-                };
+            ///
+            /// \brief  The most levels that automatic resizing grows the book
+            ///         to. Orders that would need more are rejected.
+            ///
+            std::size_t maximum_levels = std::size_t(1) << 22;
+
+            ///
+            /// \brief  The range of limit prices currently accepted
+            ///
+            [[nodiscard]] const mathematics::interval<quote> &range() const
+            {
+                return valid_limits;
             }
 
             ///
             /// \brief  Resize the order book when market prices move outside of
             ///         the allowed range.
             ///
-            /// \details    This operation is costly, and must be avoided by
-            ///             choosing sensible limits for minimum and maximum
-            ///             allowed prices.
-            ///
+            /// \details    Resting orders outside the new range are cancelled,
+            ///             the others keep their order identifiers. Produces
+            ///             an `execution_report::resize` report, with the new
+            ///             minimum quote and the number of levels.
+            ///             This takes time proportional to the number of levels,
+            ///             so sensible limits for minimum and maximum allowed
+            ///             prices avoid frequent resizing.
             ///
-            /// \param new_limits
+            /// \param new_limits  Must be ticks of this book, in the quote
+            ///                    type, currency and lot size of the book
             void resize(const mathematics::interval<quote> &new_limits)
             {
-                // this is a naive implementation, that may hit memory limits
-                // quickly (worst case, resizing from n to size m, it uses n+m
-                // while resizing).
-
-                std::vector<limit_type> new_limits_;
-
-
-
-                valid_limits = new_limits;
+                limit lower_;
+                limit upper_;
+                if(!to_ticks(new_limits.lower, lower_)
+                   || !to_ticks(new_limits.upper, upper_)
+                   || upper_ < lower_){
+                    throw esl::exception("order book limits must be ticks of the order book");
+                }
+                relocate(lower_, std::size_t(upper_ - lower_ + 1));
             }
 
             ///
@@ -255,11 +538,10 @@ namespace esl::economics::markets::order_book {
             /// \return
             [[nodiscard]] std::optional<quote> bid() const override
             {
-                if(!best_bid_->first){
+                if(!best_bid_){
                     return {};
                 }
-                std::ptrdiff_t limit_ = best_bid_ - &limits_[0];
-                return decode(valid_limits, limit_);
+                return decode(best_bid_ - &limits_[0]);
             }
 
             ///
@@ -268,12 +550,10 @@ namespace esl::economics::markets::order_book {
             /// \return
             [[nodiscard]] std::optional<quote> ask() const override
             {
-                if(!best_ask_->first){
+                if(!best_ask_){
                     return {};
                 }
-
-                std::ptrdiff_t limit_ = best_ask_ - &limits_[0];
-                return decode(valid_limits, limit_);
+                return decode(best_ask_ - &limits_[0]);
             }
 
             ///
@@ -288,23 +568,13 @@ namespace esl::economics::markets::order_book {
                 , std::uint32_t &remainder_
                 , limit_type *level)
             {
-                for( auto ao = level->first
-                    ; 0 < remainder_
-                    ; ao = ao->data.successor){
-                    uint32_t execution_size_ = 0;
-
-                    if(ao->data.quantity > remainder_){
-                        execution_size_ = remainder_;
-                        ao->data.quantity -= execution_size_;
-                        remainder_ = 0;
-                    }else{
-                        execution_size_ = ao->data.quantity;
-                        remainder_ -= execution_size_;
-                        ao->data.quantity = 0;
-                        level->first = ao->data.successor;
-                    }
+                auto quote_ = decode(level - &limits_[0]);
+                while(0 < remainder_ && level->first){
+                    auto *ao = level->first;
+                    auto execution_size_ = std::min(ao->data.quantity, remainder_);
+                    ao->data.quantity -= execution_size_;
+                    remainder_ -= execution_size_;
 
-                    auto quote_ = decode(valid_limits, level - &limits_[0]);
                     // execution report for liquidity taker
                     reports.emplace_back(execution_report
                                              ( execution_report::match
@@ -318,39 +588,18 @@ namespace esl::economics::markets::order_book {
                     // execution report for supplier
                     reports.emplace_back(execution_report
                                              ( execution_report::match
-                                             , (order.side == limit_order_message::sell ?   limit_order_message::buy :  limit_order_message::sell)
+                                             , ao->data.side
                                              ,  execution_size_
                                              , ao->index
                                              , quote_
                                              , ao->data.owner
                                              ));
 
-                    if(!ao->data.successor){
-                        if(0 == ao->data.quantity){
-                            // special case where level is emptied entirely
-                            // we need to reset the pointers in the memory pool
-                            level->first = nullptr;
-                            level->second = nullptr;
-
-                            // if the aggressor was a buy order, it took away
-                            // the best ask
-                            if(order.side == limit_order_message::buy){
-                                LOG(trace) << quote_ << " ask level depleted" << std::endl;
-                                for(++best_ask_; best_ask_ <= &limits_.back(); ++best_ask_){
-                                    if(best_ask_->first || best_ask_ == &limits_.back()){
-                                        break;
-                                    }
-                                }
-                            }else{
-                                LOG(trace) << quote_ << " bid level depleted" << std::endl;
-                                for(--best_bid_; best_bid_ >= &limits_[0]; --best_bid_){
-                                    if(best_bid_->first || best_bid_ == &limits_[0]){
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                        break;
+                    if(0 == ao->data.quantity){
+                        // filled orders leave the queue and return their
+                        // block to the pool
+                        unlink(ao);
+                        pool_.erase(ao->index);
                     }
                 }
                 return remainder_;
@@ -362,18 +611,20 @@ namespace esl::economics::markets::order_book {
             /// \return
             void insert(const limit_order_message &order) override
             {
-                if(!valid_limits.contains(order.limit) || 0 >= order.quantity || order.limit.lot != valid_limits.lower.lot ){
+                limit limit_index_ = 0;
+                bool valid_ = 0 < order.quantity && encode(order.limit, limit_index_);
+                if(!valid_ && automatic_resize && 0 < order.quantity
+                   && to_ticks(order.limit, limit_index_)){
+                    valid_ = recentre(limit_index_)
+                          && encode(order.limit, limit_index_);
+                }
 
-                    if(!valid_limits.contains(order.limit)){
-                        LOG(trace) << "Order invalid because it is outside the accepted range: " << this->valid_limits << std::endl;
-                    }
+                if(!valid_){
 
                     if(0 >= order.quantity){
                         LOG(trace) << "Order invalid because it does not have positive quantity " << order.quantity << std::endl;
-                    }
-
-                    if(order.limit.lot != valid_limits.lower.lot){
-                        LOG(trace) << "Order invalid because it does not use an acceptable lot size " << order.limit.lot << " !=  " << valid_limits.lower.lot << std::endl;
+                    }else{
+                        LOG(trace) << "Order invalid because it is not a tick in the accepted range " << this->valid_limits << " with lot size " << valid_limits.lower.lot << std::endl;
                     }
 
                     reports.emplace_back(execution_report
@@ -388,36 +639,30 @@ namespace esl::economics::markets::order_book {
                 }
 
                 std::uint32_t remainder_ = order.quantity;
-                limit limit_index_;
-                auto encode_success_ = encode(valid_limits, order.limit, limit_index_);
-                assert( encode_success_
-                        && limit_index_ >= 0
-                        && limits_.size() > static_cast<uint64_t>(limit_index_));
                 limit_type *limit_level_ = &limits_[limit_index_];
 
                 if( order.side == limit_order_message::buy
-                    && ask().has_value()
-                    && order.limit >= ask().value()) {
+                    && best_ask_
+                    && limit_level_ >= best_ask_) {
                     // direct execution: buyer aggressor
                     LOG(trace) << "buyer aggressor" << std::endl;
-                    for(auto al = best_ask_; al <= limit_level_ && 0 < remainder_; ++al){
-                        if(!al->first){
-                            continue;
-                        }
-                        remainder_ = match_at_level(order, remainder_, al);
+                    // emptied levels move the best ask to the next
+                    // occupied level
+                    while(0 < remainder_ && best_ask_
+                          && best_ask_ <= limit_level_){
+                        remainder_ = match_at_level(order, remainder_, best_ask_);
                     }
 
                 }else if(  order.side == limit_order_message::sell
-                           && bid().has_value()
+                           && best_bid_
+                           && limit_level_ <= best_bid_
                     ){
                     // direct execution: seller aggressor
                     LOG(trace) << "seller aggressor" << std::endl;
-                    for(auto bl = best_bid_; bl >= limit_level_ && 0 < remainder_; --bl){
-                        if(!bl->first){
-                            continue;
-                        }
-                        LOG(trace) << "\t ask " << remainder_ << " units found bid(s) at " << (decode(valid_limits, bl - &limits_[0])) << std::endl;
-                        remainder_ = match_at_level(order, remainder_, bl);
+                    while(0 < remainder_ && best_bid_
+                          && best_bid_ >= limit_level_){
+                        LOG(trace) << "\t ask " << remainder_ << " units found bid(s) at " << decode(best_bid_ - &limits_[0]) << std::endl;
+                        remainder_ = match_at_level(order, remainder_, best_bid_);
                     }
 
                 }else if(  order.lifetime == limit_order_message::immediate_or_cancel
@@ -452,10 +697,12 @@ namespace esl::economics::markets::order_book {
                 }
 
                 auto block_ = pool_.emplace(record
-                                                { order.limit
-                                                , remainder_
+                                                { remainder_
                                                 , order.owner
                                                 , nullptr
+                                                , limit_level_->second
+                                                , base_ + limit_index_
+                                                , order.side
                                                 });
 
                 reports.emplace_back(execution_report
@@ -470,15 +717,16 @@ namespace esl::economics::markets::order_book {
                 if(!limit_level_->first){
                     limit_level_->first = block_.second;
                     limit_level_->second = block_.second;
+                    occupied_.set(limit_index_);
                 }else{
                     limit_level_->second->data.successor = block_.second;
                     limit_level_->second = block_.second;
                 }
 
                 if(limit_order_message::buy == order.side){
-                    best_bid_ = std::max(best_bid_,  limit_level_);
+                    best_bid_ = best_bid_ ? std::max(best_bid_, limit_level_) : limit_level_;
                 }else if(order.side == limit_order_message::sell){
-                    best_ask_ = std::min(best_ask_,  limit_level_);
+                    best_ask_ = best_ask_ ? std::min(best_ask_, limit_level_) : limit_level_;
                 }
                 // TODO: notify new best bid/ask
             }
@@ -486,33 +734,32 @@ namespace esl::economics::markets::order_book {
 
             ///
             /// \brief  Cancels an order by the order identifier returned from
-            ///         the order book.
+            ///         the order book, in constant time.
+            ///
+            /// \details    Orders that were already filled or cancelled are
+            ///             ignored, and produce no report.
             ///
             /// \param order
             void cancel(basic_book::order_identifier order) override
             {
-                auto index_ = (std::uint64_t)( order );
-
-                const record &order_ = pool_[order];
-
-                auto side_ = limit_order_message::side_t::buy;
-                // if there is no bid, or the best bid is lower than this order,
-                // this must be a sell order.
-                auto bid_ = bid();
-                if(!bid_.has_value() || bid_.value() < order_.limit){
-                    side_ = limit_order_message::side_t::sell;
+                auto *block_ = pool_.find(order);
+                if(!block_){
+                    LOG(trace) << "order " << order << " was filled or cancelled before" << std::endl;
+                    return;
                 }
 
+                const record &order_ = block_->data;
                 reports.emplace_back(execution_report
                                          ( execution_report::cancel
-                                         , side_
+                                         , order_.side
                                          , order_.quantity
                                          , order
-                                         , order_.limit
+                                         , decode(order_.level - base_)
                                          , order_.owner
                                          ));
 
-                pool_.erase(index_);
+                unlink(block_);
+                pool_.erase(order);
             }
 
             ///
@@ -520,74 +767,65 @@ namespace esl::economics::markets::order_book {
             ///         for use in a terminal/IDE.
             ///
             /// \param levels
-            void display(std::uint64_t levels = 5) const
+            void display(std::uint64_t levels = 5) const override
             {
+                std::ios_base::fmtflags flags_(std::cout.flags());
                 std::cout << "            bid |                | ask            "
                           << std::endl;
 
                 std::uint64_t displayed_ = 0;
-                std::vector<std::pair<std::uint32_t, double>> ask_displayed_;
-                for(auto i = best_ask_; i <= &limits_[limits_.size() - 1] && displayed_ < levels; ++i) {
-                    if(!i->first) {
-                        continue;
-                    }
+                std::vector<std::pair<std::uint64_t, price_t_>> ask_displayed_;
+                for( auto l = best_ask_ ? best_ask_ - &limits_[0] : computation::hierarchical_bitmap::npos
+                   ; computation::hierarchical_bitmap::npos != l && displayed_ < levels
+                   ; l = occupied_.next(l + 1)) {
+                    auto *i = &limits_[l];
                     std::uint64_t quantity_ = 0;
                     for(auto *j = i->first; nullptr != j;
                         j       = j->data.successor) {
                         quantity_ += j->data.quantity;
                     }
-                    if(quantity_ <= 0) {
-                        continue;
-                    }
-
-                    ask_displayed_.emplace_back(quantity_,double(decode(valid_limits, i - &limits_[0]))*100*100);
-                    /*std::cout << "                | "
-                              << std::left << std::setw(14)
-                              << std::setprecision(int(std::log10(valid_limits.lower.lot ))) << double(decode(valid_limits, i - &limits_[0]))*100*100
-                              << " | "
-                              << std::left << std::setw(15)
-                              << quantity_
-                              << std::endl;*/
+                    ask_displayed_.emplace_back(quantity_, level_price(i - &limits_[0]));
                     ++displayed_;
                 }
 
                 for(auto r = ask_displayed_.rbegin(); r!= ask_displayed_.rend(); ++r){
                     std::cout << "                | "
                               << std::left << std::setw(14)
-                              << std::setprecision(int(std::log10(valid_limits.lower.lot ))) << r->second
+                              << double(r->second)
                               << " | "
                               << std::left << std::setw(15)
                               << r->first
                               << std::endl;
                 }
 
-                //std::cout << "------------------------------------------------" << std::endl;
-
                 displayed_ = 0;
-                for(auto i = best_bid_; i >= &limits_[0] && displayed_ < levels; --i) {
-                    if(!i->first) {
-                        continue;
-                    }
+                for( auto l = best_bid_ ? best_bid_ - &limits_[0] : computation::hierarchical_bitmap::npos
+                   ; computation::hierarchical_bitmap::npos != l && displayed_ < levels
+                   ; l = (0 == l ? computation::hierarchical_bitmap::npos : occupied_.previous(l - 1))) {
+                    auto *i = &limits_[l];
                     std::uint64_t quantity_ = 0;
                     for(auto *j = i->first; nullptr != j;
                         j       = j->data.successor) {
                         quantity_ += j->data.quantity;
                     }
-                    if(quantity_ <= 0) {
-                        continue;
-                    }
                     std::cout << std::right << std::setw(15)
                               << quantity_ << " | "
                               << std::left << std::setw(14)
-                              << std::setprecision(int(std::log10(valid_limits.lower.lot  ))) << double(decode(valid_limits, i - &limits_[0]))*100*100
+                              << double(level_price(i - &limits_[0]))
                               << " | "
                               << std::endl;
                     ++displayed_;
                 }
-
+                std::cout.flags(flags_);
             }
 
         };
+
+        ///
+        /// \brief  Order book for prices, with a price level for every unit of
+        ///         the minor currency unit
+        ///
+        typedef basic_static_order_book<price, 1> static_order_book;
 }//namespace
 
 #endif  // ESL_STATIC_ORDER_BOOK_HPP
@@ -69,7 +69,7 @@ struct order_message
     void serialize(archive_t &archive, const unsigned int version)
     {
         (void)version;
-        archive &make_nvp(
+        archive &boost::serialization::make_nvp(
             "interaction〈message_type_,type_code_〉",
             boost::serialization::base_object<
             interaction::message<message_type_, type_code_>>(
@@ -25,6 +25,12 @@
 #ifndef ESL_QUOTE_MESSAGE_HPP
 #define ESL_QUOTE_MESSAGE_HPP
 
+#include <memory>
+
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/unordered_map.hpp>
+
 #include <esl/interaction/message.hpp>
 #include <esl/law/property_collection.hpp>
 #include <esl/economics/markets/quote.hpp>
@@ -41,9 +47,11 @@ namespace esl::economics::markets {
     : public interaction::message<message_type_, type_code_>
     {
         ///
-        /// \brief  Quotes for each property
+        /// \brief  Quotes for each property. Markets send the same quotes to
+        ///         all participants, so these are shared between messages
+        ///         and may not be modified.
         ///
-        law::property_map<quote> proposed;
+        std::shared_ptr<const law::property_map<quote>> proposed;
 
         ///
         /// \brief  Whether the sender is bound to deliver on the offered
@@ -63,6 +71,25 @@ namespace esl::economics::markets {
             simulation::time_point received   = simulation::time_point())
         : interaction::message<message_type_, type_code_>(sender, recipient,
                                                           sent, received)
+        , proposed(std::make_shared<const law::property_map<quote>>(move(proposed)))
+        , binding(binding)
+        {
+
+        }
+
+        ///
+        /// \brief  Creates a message that shares the quotes with other
+        ///         messages.
+        ///
+        quote_message(
+            identity<agent> sender,
+            identity<agent> recipient,
+            std::shared_ptr<const law::property_map<quote>> proposed,
+            indication binding              = indication::firm,
+            simulation::time_point sent     = simulation::time_point(),
+            simulation::time_point received = simulation::time_point())
+        : interaction::message<message_type_, type_code_>(sender, recipient,
+                                                          sent, received)
         , proposed(move(proposed))
         , binding(binding)
         {
@@ -75,11 +102,24 @@ namespace esl::economics::markets {
         void serialize(archive_t &archive, const unsigned int version)
         {
             (void)version;
-            archive &make_nvp(
+            archive &boost::serialization::make_nvp(
                 "interaction〈message_type_,type_code_〉",
                 boost::serialization::base_object<
                     interaction::message<message_type_, type_code_>>(*this));
-            archive &BOOST_SERIALIZATION_NVP(proposed);
+            // the quotes are written by value, and each message that is
+            // loaded gets its own copy. A message without quotes is written
+            // with an empty map
+            law::property_map<quote> proposed_;
+            if constexpr(archive_t::is_saving::value) {
+                if(proposed) {
+                    proposed_ = *proposed;
+                }
+            }
+            archive &boost::serialization::make_nvp("proposed", proposed_);
+            if constexpr(archive_t::is_loading::value) {
+                proposed = std::make_shared<const law::property_map<quote>>(
+                    std::move(proposed_));
+            }
             archive & BOOST_SERIALIZATION_NVP(binding);
         }
     };
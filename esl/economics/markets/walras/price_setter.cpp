@@ -162,20 +162,20 @@ namespace esl::economics::markets::walras {
             }
         }
 
-        law::property_map<quote> quote_map_;
+        auto quote_map_ = std::make_shared<law::property_map<quote>>();
         {
             size_t sequence_ = 0;
             for(const auto &[k, v]: traded_properties) {
-                quote_map_.insert({k, quotes_[sequence_]});
+                quote_map_->insert({k, quotes_[sequence_]});
                 ++sequence_;
             }
         }
 //        LOG(trace) << describe() << " " << identifier << " time " << step.lower <<  " clearing prices " << quote_map_ << std::endl;
 
-        for(const auto &p : participants) {
-            auto m = this->template create_message<walras::quote_message>(
-                p, step.lower + 1, identifier, p, quote_map_);
-        }
+        // all participants share the same quotes
+        this->template create_multicast<walras::quote_message>(
+            participants, step.lower + 1, identifier, identity<agent>(),
+            std::shared_ptr<const law::property_map<quote>>(quote_map_));
         state = clearing_market;
         return next_;
     }
@@ -52,6 +52,20 @@ namespace esl::economics::markets::walras {
 
         }
 
+        quote_message(
+            identity<agent> sender,
+            identity<agent> recipient,
+            std::shared_ptr<const law::property_map<quote>> proposed,
+            simulation::time_point sent     = simulation::time_point(),
+            simulation::time_point received = simulation::time_point())
+        : markets::quote_message<
+            quote_message, interaction::library_message_code<0x00A0U>()>(
+            std::move(sender), std::move(recipient), std::move(proposed),
+            markets::indication::indicative, sent, received)
+        {
+
+        }
+
         virtual ~quote_message() = default;
 
         template<class archive_t>
@@ -29,6 +29,9 @@
 #include <string>
 #include <locale>
 
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/string.hpp>
 
 #include <esl/economics/iso_4217.hpp>
 
@@ -249,7 +252,7 @@ namespace esl::economics {
 //        }
 
         template<class archive_t>
-        void serialize(archive_t &archive, const unsigned int version)
+        void save(archive_t &archive, const unsigned int version) const
         {
             (void)version;
             //archive &BOOST_SERIALIZATION_NVP(value);
@@ -264,7 +267,33 @@ namespace esl::economics {
 
             std::string res_ = stream_.str();
 
-            archive & boost::serialization::make_nvp("price", res_);
+            archive << boost::serialization::make_nvp("price", res_);
+        }
+
+        ///
+        /// \brief  Reads the price in the form written by `save`, for
+        ///         example "USD 125/100"
+        ///
+        template<class archive_t>
+        void load(archive_t &archive, const unsigned int version)
+        {
+            (void)version;
+            std::string res_;
+            archive >> boost::serialization::make_nvp("price", res_);
+
+            std::stringstream stream_(res_);
+            std::array<char, 3> code_ = {'X', 'X', 'X'};
+            stream_.read(code_.data(), code_.size());
+            char separator_ = 0;
+            std::uint64_t denominator_ = 0;
+            stream_ >> value >> separator_ >> denominator_;
+            valuation = iso_4217(code_, denominator_);
+        }
+
+        template<class archive_t>
+        void serialize(archive_t &archive, const unsigned int version)
+        {
+            boost::serialization::split_member(archive, *this, version);
         }
     };
 }
@@ -25,6 +25,7 @@
 #include <esl/interaction/communicator.hpp>
 #include <esl/data/log.hpp>
 
+#include <algorithm>
 #include <chrono>
 using std::chrono::high_resolution_clock;
 
@@ -36,7 +37,34 @@ namespace esl::interaction {
 
     }
 
-    std::map<std::string, double> timings_callback_;
+    const communicator::dispatch_entry *
+    communicator::find_dispatch(message_code type) const
+    {
+        auto i = std::lower_bound(dispatch_.begin(), dispatch_.end(), type,
+            [](const dispatch_entry &e, message_code t) { return e.type < t; });
+        if(dispatch_.end() == i || type != i->type) {
+            return nullptr;
+        }
+        return &*i;
+    }
+
+    void communicator::add_dispatch(message_code type, priority_t priority,
+                                    const callback_t &callback)
+    {
+        auto i = std::lower_bound(dispatch_.begin(), dispatch_.end(), type,
+            [](const dispatch_entry &e, message_code t) { return e.type < t; });
+        if(dispatch_.end() == i || type != i->type) {
+            i = dispatch_.insert(i, {type, priority, {}});
+        }
+
+        // higher priorities are called first, and callbacks of equal
+        // priority in reverse order of registration
+        auto &entries_ = i->callbacks;
+        auto position_ = std::find_if(entries_.begin(), entries_.end(),
+            [priority](const auto &c) { return c.first <= priority; });
+        entries_.insert(position_, {priority, callback});
+        i->priority = entries_.front().first;
+    }
 
     ///
     /// \brief  Handles a single message, calling all associated callbacks
@@ -47,29 +75,41 @@ namespace esl::interaction {
     /// \return time_point of the next event as the minimum of all future events
     ///         returned by the callback functions.
     simulation::time_point
-    communicator::process_message(message_t message,
+    communicator::process_message(const message_t &message,
                                   simulation::time_interval step,
                                   std::seed_seq &seed) const
     {
         auto first_event_ = step.upper;
 
-        auto callback_ = callbacks_.find(message->type);
-        if(callbacks_.end() == callback_) {
+        const auto *entry_ = find_dispatch(message->type);
+        if(nullptr == entry_) {
             return first_event_;
         }
 
-        for(auto i = callback_->second.rbegin(); i != callback_->second.rend();
-            ++i) {
-            timings_callback_.emplace(std::get<1>(*i).description, 0.);
-            auto before_handler_ = high_resolution_clock::now();
+#ifdef WITH_PROFILING
+        auto &profiler_ = computation::profiler::instance();
+        const bool profile_ = profiler_.enabled();
+#endif
 
-            auto next_event_ = std::get<1>(*i).function(message, step, seed);
+        for(const auto &[p, c] : entry_->callbacks) {
+            (void) p;
+            simulation::time_point next_event_;
+#ifdef WITH_PROFILING
+            if(profile_) {
+                auto before_handler_ = high_resolution_clock::now();
+                next_event_ = c.function(message, step, seed);
+                profiler_.record(c.site,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        high_resolution_clock::now() - before_handler_));
+            }else{
+                next_event_ = c.function(message, step, seed);
+            }
+#else
+            next_event_ = c.function(message, step, seed);
+#endif
             assert(step.lower <= next_event_ && next_event_ <= step.upper);
             first_event_ = std::min(first_event_, next_event_);
 
-            timings_callback_[std::get<1>(*i).description] += double(
-                    (high_resolution_clock::now() - before_handler_).count());
-
 //            if (step.lower % 1000 == 0) {
 //                std::cout << std::get<1>(*i).description << ": "
 //                          << timings_callback_[std::get<1>(*i).description] / 1e+9 / step.lower << " s" << std::endl;
@@ -91,53 +131,45 @@ namespace esl::interaction {
     communicator::process_messages(const simulation::time_interval &step,
                                    std::seed_seq &seed)
     {
-        // create mapping priority -> message
-
-
-
-        std::multimap<priority_t, message_t, std::less<>,     boost::fast_pool_allocator<std::pair<const priority_t, message_t> >       > priority_;
+        // messages to process, by descending priority. Messages with equal
+        // priority are processed in reverse order of arrival, as before
+        pending_.clear();
         for(const auto &[k, m] : inbox) {
             // message will be received in the future
             if(k > step.lower) {
                 break;
             }
 
-            auto callback_ = callbacks_.find(m->type);
-            if(callbacks_.end() == callback_ || callback_->second.empty()) {
+            const auto *entry_ = find_dispatch(m->type);
+            if(nullptr == entry_) {
                 continue;  // no callbacks that process this message
             }
 
-            auto highest_priority = std::numeric_limits<priority_t>::min();
-            for(const auto &[p, cf] : callback_->second) {
-                (void) cf;
-                highest_priority = std::max(highest_priority, p);
-            }
-
-            priority_.insert(std::make_pair(highest_priority, m));
+            pending_.emplace_back(entry_->priority, &m);
         }
+        std::reverse(pending_.begin(), pending_.end());
+        std::stable_sort(pending_.begin(), pending_.end(),
+                         [](const auto &a, const auto &b) {
+                             return a.first > b.first;
+                         });
 
         auto first_event_ = step.upper;
 
-        for(auto i = priority_.rbegin(); i != priority_.rend(); ++i) {
-            std::vector<message_t> equal_;
-            for(auto upper_ = i;
-                upper_ != priority_.rend() && upper_->first == i->first;
-                ++upper_) {
-                equal_.push_back(upper_->second);
-                i = upper_;
-            }
+        for(auto i = pending_.begin(); i != pending_.end();) {
+            auto upper_ = std::find_if(i, pending_.end(), [&](const auto &p) {
+                return p.first != i->first;
+            });
 
             if(random == schedule) {
-                std::minstd_rand g(seed);
-                std::shuffle(equal_.begin(), equal_.end(), g);
+                std::shuffle(i, upper_, rng);
             }
 
-            for(const auto &m : equal_) {
-                auto next_event_ = process_message(m, step, seed);
+            for(; i != upper_; ++i) {
+                auto next_event_ = process_message(*i->second, step, seed);
                 first_event_     = std::min(first_event_, next_event_);
-
             }
         }
+        pending_.clear();
         return first_event_;
     }
 
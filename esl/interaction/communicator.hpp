@@ -26,17 +26,23 @@
 #define ESL_SIMULATION_COMMUNICATOR_HPP
 
 
+#include <cassert>
 #include <functional>
 #include <map>
 #include <memory>
 #include <random>
+#include <vector>
 
 #include <boost/serialization/map.hpp>
 #include <boost/serialization/nvp.hpp>
 #include <boost/pool/poolfwd.hpp>
 
 #include <esl/computation/allocator.hpp>
+#include <esl/computation/profiler.hpp>
+#include <esl/computation/random.hpp>
 #include <esl/interaction/header.hpp>
+#include <esl/interaction/inbox.hpp>
+#include <esl/interaction/message_arena.hpp>
 
 
 namespace esl::simulation {
@@ -94,17 +100,19 @@ namespace esl::interaction {
             /// \brief The line in the file where it is defined
             ///
             size_t        line;
+
+            ///
+            /// \brief  Identifies the callback to the profiler, see
+            ///         `computation::profiler`.
+            ///
+            computation::profiler::site_t site = 0;
         };
 
         ///
-        /// \brief  The inbox stores messages by delivery time.
+        /// \brief  The inbox stores messages by delivery time. Its storage
+        ///         can be chosen per agent, see `inbox::use`.
         ///
-        typedef std::multimap< simulation::time_point
-                             , message_t
-                             , std::less<>
-                             , boost::fast_pool_allocator<std::pair<const simulation::time_point, message_t> >
-                             //, computation::allocator<std::pair<const simulation::time_point, message_t> >
-                             > inbox_t;
+        typedef interaction::inbox inbox_t;
 
         ///
         typedef std::vector<message_t, boost::pool_allocator<message_t>> outbox_t;
@@ -127,6 +135,15 @@ namespace esl::interaction {
         ///
         outbox_t outbox;
 
+        ///
+        /// \brief  Random numbers for the current round. The model keys the
+        ///         stream by its sample, the agent, the time point and the
+        ///         round before the agent runs, so that drawing from it is
+        ///         reproducible regardless of the number of threads.
+        ///         Messages of equal priority are shuffled with it.
+        ///
+        computation::random_stream rng;
+
     protected:
         friend class boost::serialization::access;
 
@@ -147,6 +164,45 @@ namespace esl::interaction {
         ///
         std::map<message_code, std::multimap<priority_t, callback_t>> callbacks_;
 
+        ///
+        /// \brief  The callbacks for one message type in the order they are
+        ///         called, and the highest priority among them.
+        ///
+        struct dispatch_entry
+        {
+            message_code type;
+            priority_t priority;
+            std::vector<std::pair<priority_t, callback_t>> callbacks;
+        };
+
+        ///
+        /// \brief  Flat dispatch table sorted by message type, kept up to
+        ///         date with `callbacks_` as callbacks are registered, so
+        ///         that dispatching a message is a search over a few
+        ///         contiguous entries.
+        ///
+        std::vector<dispatch_entry> dispatch_;
+
+        ///
+        /// \return The dispatch entry for the message type, or nullptr if
+        ///         no callbacks are registered for it.
+        ///
+        const dispatch_entry *find_dispatch(message_code type) const;
+
+        ///
+        /// \brief  Adds the callback to the dispatch table.
+        ///
+        void add_dispatch(message_code type, priority_t priority,
+                          const callback_t &callback);
+
+        ///
+        /// \brief  The messages to process in the current round, with the
+        ///         highest priority of their callbacks. Reused between
+        ///         rounds. Points into the inbox, which is not modified
+        ///         while messages are processed.
+        ///
+        std::vector<std::pair<priority_t, const message_t *>> pending_;
+
     public:
         enum scheduling
         { in_order = 0,
@@ -179,6 +235,9 @@ namespace esl::interaction {
         ///
         /// \return                 shared_ptr to the
         /// message
+        ///
+        /// \details The message and its reference count are allocated
+        ///          together from the `message_arena`.
         template<typename message_type_,
                  typename recipient_t_,
                  typename... constructor_arguments_>
@@ -187,7 +246,8 @@ namespace esl::interaction {
                        simulation::time_point delivery,
                        constructor_arguments_... arguments)
         {
-            auto result_       = std::make_shared<message_type_>(arguments...);
+            auto result_ = std::allocate_shared<message_type_>(
+                message_arena::allocator<message_type_>(), arguments...);
             assert(0 < recipient.digits.size());
             result_->recipient = recipient;
             result_->received  = delivery;
@@ -196,6 +256,45 @@ namespace esl::interaction {
             return result_;
         }
 
+        ///
+        /// \brief  Create a message for each of the recipients and queue
+        ///         them for sending.
+        ///
+        /// \details Each recipient receives its own message, because
+        ///          recipients may reply using the `recipient` field. The
+        ///          first message is constructed from `arguments`, and the
+        ///          others are copied from it. To send a large payload once,
+        ///          the message should hold it by shared pointer to const,
+        ///          so that only the headers are copied.
+        ///
+        /// \param recipients       Container of recipient identities
+        /// \param delivery         The time_point at which the messages
+        ///                         become available to the recipients
+        /// \param arguments        arguments to the message's constructor
+        template<typename message_type_,
+                 typename recipients_t_,
+                 typename... constructor_arguments_>
+        void create_multicast(const recipients_t_ &recipients,
+                              simulation::time_point delivery,
+                              constructor_arguments_... arguments)
+        {
+            message_arena::allocator<message_type_> allocator_;
+            std::shared_ptr<message_type_> prototype_;
+            for(const auto &r : recipients) {
+                auto result_ = prototype_
+                    ? std::allocate_shared<message_type_>(allocator_, *prototype_)
+                    : std::allocate_shared<message_type_>(allocator_, arguments...);
+                if(!prototype_) {
+                    prototype_ = result_;
+                }
+                assert(0 < r.digits.size());
+                result_->recipient = r;
+                result_->received  = delivery;
+
+                this->outbox.push_back(std::move(result_));
+            }
+        }
+
         ///
         /// \brief  Prepare a message for sending, putting a pointer to it in
         ///         the outbox
@@ -244,11 +343,13 @@ namespace esl::interaction {
             auto function_ = [callback](message_t m,
                                         simulation::time_interval step,
                                         std::seed_seq &seed) {
-                // dynamically cast message to derived type that was asked for
+                // messages are dispatched by type code, which guarantees the
+                // message derives from the type that was asked for
+                assert(nullptr != dynamic_cast<derived_message_t_ *>(m.get()));
                 auto converted_ =
-                    std::dynamic_pointer_cast<derived_message_t_>(m);
+                    std::static_pointer_cast<derived_message_t_>(std::move(m));
 
-                return callback(converted_, step, seed);
+                return callback(std::move(converted_), step, seed);
             };
 
             callback_t callback_ = { function_
@@ -256,7 +357,12 @@ namespace esl::interaction {
                                    , description, message, file, line
 
                                     };
+#ifdef WITH_PROFILING
+            callback_.site = computation::profiler::instance().register_site(
+                description, message, file, line);
+#endif
             iterator_->second.emplace(priority, callback_);
+            add_dispatch(type_code_, priority, callback_);
         }
 
         [[nodiscard]] inline const decltype(callbacks_) &callbacks() const
@@ -272,7 +378,7 @@ namespace esl::interaction {
         /// \param message
         /// \return
         simulation::time_point
-        process_message(message_t message,
+        process_message(const message_t &message,
                         simulation::time_interval step,
                         std::seed_seq &seed) const;
 
@@ -0,0 +1,199 @@
+/// \file   inbox.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <esl/interaction/inbox.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+
+namespace esl::interaction {
+
+    inbox::inbox(storage_t storage)
+    : storage_(storage)
+    , used_(0)
+    , messages_(0)
+    {
+
+    }
+
+    inbox::inbox(const inbox &o)
+    : inbox(o.storage_)
+    {
+        for(const auto &v : o) {
+            insert(v);
+        }
+    }
+
+    inbox::inbox(inbox &&o) noexcept
+    : storage_(o.storage_)
+    , ordered_(std::move(o.ordered_))
+    , buckets_(std::move(o.buckets_))
+    , used_(std::exchange(o.used_, 0))
+    , messages_(std::exchange(o.messages_, 0))
+    {
+
+    }
+
+    inbox &inbox::operator = (inbox &&o) noexcept
+    {
+        if(this != &o) {
+            storage_  = o.storage_;
+            ordered_  = std::move(o.ordered_);
+            buckets_  = std::move(o.buckets_);
+            used_     = std::exchange(o.used_, 0);
+            messages_ = std::exchange(o.messages_, 0);
+        }
+        return *this;
+    }
+
+    inbox &inbox::operator = (const inbox &o)
+    {
+        if(this != &o) {
+            clear();
+            storage_ = o.storage_;
+            for(const auto &v : o) {
+                insert(v);
+            }
+        }
+        return *this;
+    }
+
+    void inbox::use(storage_t storage)
+    {
+        if(storage == storage_) {
+            return;
+        }
+        inbox moved_(storage);
+        for(auto &v : *this) {
+            moved_.insert({v.first, std::move(v.second)});
+        }
+        *this = std::move(moved_);
+    }
+
+    inbox::size_type inbox::locate(key_type time) const
+    {
+        // messages mostly arrive for the latest time, so search from the back
+        auto b = used_;
+        while(0 < b && time < buckets_[b - 1].time) {
+            --b;
+        }
+        if(0 < b && time == buckets_[b - 1].time) {
+            return b - 1;
+        }
+        return b;
+    }
+
+    inbox::iterator inbox::insert(value_type v)
+    {
+        if(ordered == storage_) {
+            return iterator(this, ordered_.insert(std::move(v)), 0, 0);
+        }
+
+        auto b = locate(v.first);
+        if(b == used_ || buckets_[b].time != v.first) {
+            // move an empty bucket into place
+            if(used_ == buckets_.size()) {
+                buckets_.emplace_back();
+            }
+            std::rotate( buckets_.begin() + b
+                       , buckets_.begin() + used_
+                       , buckets_.begin() + used_ + 1);
+            buckets_[b].time = v.first;
+            ++used_;
+        }
+        buckets_[b].messages.push_back(std::move(v));
+        ++messages_;
+        return iterator(this, ordered_.end(), b, buckets_[b].messages.size() - 1);
+    }
+
+    inbox::iterator inbox::find(key_type time)
+    {
+        if(ordered == storage_) {
+            return iterator(this, ordered_.find(time), 0, 0);
+        }
+        auto b = locate(time);
+        if(b == used_ || buckets_[b].time != time) {
+            return end();
+        }
+        return iterator(this, ordered_.end(), b, 0);
+    }
+
+    inbox::size_type inbox::erase(key_type time)
+    {
+        if(ordered == storage_) {
+            return ordered_.erase(time);
+        }
+        auto b = locate(time);
+        if(b == used_ || buckets_[b].time != time) {
+            return 0;
+        }
+        auto removed_ = buckets_[b].messages.size();
+        buckets_[b].messages.clear();
+        // keep the emptied bucket as a spare
+        std::rotate( buckets_.begin() + b
+                   , buckets_.begin() + b + 1
+                   , buckets_.begin() + used_);
+        --used_;
+        messages_ -= removed_;
+        return removed_;
+    }
+
+    inbox::size_type inbox::erase_until(key_type time)
+    {
+        if(ordered == storage_) {
+            auto end_     = ordered_.upper_bound(time);
+            auto removed_ = size_type(std::distance(ordered_.begin(), end_));
+            ordered_.erase(ordered_.begin(), end_);
+            return removed_;
+        }
+        auto n = locate(time);
+        if(n < used_ && buckets_[n].time == time) {
+            ++n;
+        }
+        size_type removed_ = 0;
+        for(size_type b = 0; b < n; ++b) {
+            removed_ += buckets_[b].messages.size();
+            buckets_[b].messages.clear();
+        }
+        // keep the emptied buckets as spares
+        std::rotate( buckets_.begin()
+                   , buckets_.begin() + n
+                   , buckets_.begin() + used_);
+        used_     -= n;
+        messages_ -= removed_;
+        return removed_;
+    }
+
+    void inbox::clear()
+    {
+        ordered_.clear();
+        for(size_type b = 0; b < used_; ++b) {
+            buckets_[b].messages.clear();
+        }
+        used_     = 0;
+        messages_ = 0;
+    }
+}  // namespace esl::interaction
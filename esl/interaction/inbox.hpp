@@ -0,0 +1,337 @@
+/// \file   inbox.hpp
+///
+/// \brief  Stores an agent's received messages by delivery time.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_INTERACTION_INBOX_HPP
+#define ESL_INTERACTION_INBOX_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/split_member.hpp>
+
+#include <esl/interaction/header.hpp>
+#include <esl/simulation/time.hpp>
+
+
+namespace esl::interaction {
+
+    ///
+    /// \brief  A multimap from delivery time to message, with a choice of
+    ///         storage.
+    ///
+    /// \details    Iteration visits messages by increasing delivery time, and
+    ///             messages with the same delivery time in the order they
+    ///             were inserted, regardless of the storage used.
+    ///
+    ///             `ordered` storage is a balanced tree whose nodes come from
+    ///             a shared pool allocator. `bucketed` storage is a short,
+    ///             sorted calendar with one vector of messages per delivery
+    ///             time. It is meant for the common case where messages are
+    ///             due in the current or the next time step: inserting
+    ///             appends to a vector and clearing keeps all capacity, so
+    ///             that after the first rounds the inbox does not allocate.
+    ///
+    class inbox
+    {
+    public:
+        typedef simulation::time_point key_type;
+
+        typedef std::shared_ptr<header> mapped_type;
+
+        typedef std::pair<const key_type, mapped_type> value_type;
+
+        typedef std::size_t size_type;
+
+        typedef std::ptrdiff_t difference_type;
+
+        typedef std::less<> key_compare;
+
+        ///
+        /// \brief  The container used for `ordered` storage.
+        ///
+        typedef std::multimap< key_type
+                             , mapped_type
+                             , key_compare
+                             , boost::fast_pool_allocator<value_type>
+                             > ordered_t;
+
+        enum storage_t
+        { ordered  = 0
+        , bucketed = 1
+        };
+
+    private:
+        ///
+        /// \brief  The messages with one delivery time, in insertion order.
+        ///
+        struct bucket
+        {
+            key_type time;
+            std::vector<value_type> messages;
+        };
+
+        storage_t storage_;
+
+        ordered_t ordered_;
+
+        ///
+        /// \brief  The first `used_` buckets hold messages and are sorted by
+        ///         time. The remaining buckets are empty and kept for reuse.
+        ///
+        std::vector<bucket> buckets_;
+
+        size_type used_;
+
+        ///
+        /// \brief  The number of messages in `buckets_`
+        ///
+        size_type messages_;
+
+        ///
+        /// \brief  Finds the live bucket with the given time, or the position
+        ///         where it would be inserted.
+        ///
+        size_type locate(key_type time) const;
+
+    public:
+        template<bool const_>
+        class basic_iterator
+        {
+        private:
+            friend class inbox;
+
+            using owner_t = std::conditional_t<const_, const inbox, inbox>;
+
+            using ordered_iterator_t =
+                std::conditional_t<const_, ordered_t::const_iterator,
+                                           ordered_t::iterator>;
+
+            owner_t *owner_ = nullptr;
+            ordered_iterator_t ordered_;
+            size_type bucket_ = 0;
+            size_type index_  = 0;
+
+            basic_iterator( owner_t *owner
+                          , ordered_iterator_t ordered
+                          , size_type bucket
+                          , size_type index)
+            : owner_(owner), ordered_(ordered), bucket_(bucket), index_(index)
+            {
+
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = inbox::value_type;
+            using difference_type   = inbox::difference_type;
+            using pointer   = std::conditional_t<const_, const value_type *, value_type *>;
+            using reference = std::conditional_t<const_, const value_type &, value_type &>;
+
+            basic_iterator() = default;
+
+            operator basic_iterator<true>() const
+            {
+                return basic_iterator<true>(owner_, ordered_, bucket_, index_);
+            }
+
+            reference operator * () const
+            {
+                if(ordered == owner_->storage_) {
+                    return *ordered_;
+                }
+                return owner_->buckets_[bucket_].messages[index_];
+            }
+
+            pointer operator -> () const
+            {
+                return &**this;
+            }
+
+            basic_iterator &operator ++ ()
+            {
+                if(ordered == owner_->storage_) {
+                    ++ordered_;
+                }else if(++index_ == owner_->buckets_[bucket_].messages.size()) {
+                    ++bucket_;
+                    index_ = 0;
+                }
+                return *this;
+            }
+
+            basic_iterator operator ++ (int)
+            {
+                auto result_ = *this;
+                ++*this;
+                return result_;
+            }
+
+            bool operator == (const basic_iterator &o) const
+            {
+                return ordered_ == o.ordered_ && bucket_ == o.bucket_
+                    && index_ == o.index_;
+            }
+
+            bool operator != (const basic_iterator &o) const
+            {
+                return !(*this == o);
+            }
+        };
+
+        typedef basic_iterator<false> iterator;
+
+        typedef basic_iterator<true> const_iterator;
+
+        explicit inbox(storage_t storage = ordered);
+
+        inbox(const inbox &o);
+
+        inbox(inbox &&o) noexcept;
+
+        inbox &operator = (const inbox &o);
+
+        inbox &operator = (inbox &&o) noexcept;
+
+        storage_t storage() const
+        {
+            return storage_;
+        }
+
+        ///
+        /// \brief  Changes the storage, keeping all messages.
+        ///
+        void use(storage_t storage);
+
+        size_type size() const
+        {
+            return ordered == storage_ ? ordered_.size() : messages_;
+        }
+
+        bool empty() const
+        {
+            return 0 == size();
+        }
+
+        iterator begin()
+        {
+            return iterator(this, ordered_.begin(), 0, 0);
+        }
+
+        iterator end()
+        {
+            return ordered == storage_ ? iterator(this, ordered_.end(), 0, 0)
+                                       : iterator(this, ordered_.end(), used_, 0);
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(this, ordered_.begin(), 0, 0);
+        }
+
+        const_iterator end() const
+        {
+            return ordered == storage_ ? const_iterator(this, ordered_.end(), 0, 0)
+                                       : const_iterator(this, ordered_.end(), used_, 0);
+        }
+
+        key_compare key_comp() const
+        {
+            return key_compare();
+        }
+
+        ///
+        /// \brief  Inserts the message after all messages with the same
+        ///         delivery time.
+        ///
+        iterator insert(value_type v);
+
+        ///
+        /// \brief  The first message with the given delivery time, or `end()`
+        ///
+        iterator find(key_type time);
+
+        ///
+        /// \brief  Removes all messages with the given delivery time.
+        ///
+        /// \return The number of messages removed
+        ///
+        size_type erase(key_type time);
+
+        ///
+        /// \brief  Removes all messages with a delivery time at or before
+        ///         the given time, keeping those due later.
+        ///
+        /// \return The number of messages removed
+        ///
+        size_type erase_until(key_type time);
+
+        ///
+        /// \brief  Removes all messages. With `bucketed` storage, all
+        ///         capacity is kept.
+        ///
+        void clear();
+
+        template<class archive_t>
+        void save(archive_t &archive, const unsigned int version) const
+        {
+            (void)version;
+            archive << boost::serialization::make_nvp("storage", storage_);
+            size_type count_ = size();
+            archive << BOOST_SERIALIZATION_NVP(count_);
+            for(const auto &[k, m] : *this) {
+                archive << boost::serialization::make_nvp("time", k);
+                archive << boost::serialization::make_nvp("message", m);
+            }
+        }
+
+        template<class archive_t>
+        void load(archive_t &archive, const unsigned int version)
+        {
+            (void)version;
+            clear();
+            archive >> boost::serialization::make_nvp("storage", storage_);
+            size_type count_ = 0;
+            archive >> BOOST_SERIALIZATION_NVP(count_);
+            for(size_type i = 0; i < count_; ++i) {
+                key_type time_;
+                mapped_type message_;
+                archive >> boost::serialization::make_nvp("time", time_);
+                archive >> boost::serialization::make_nvp("message", message_);
+                insert({time_, std::move(message_)});
+            }
+        }
+
+        BOOST_SERIALIZATION_SPLIT_MEMBER()
+    };
+}  // namespace esl::interaction
+
+#endif  // ESL_INTERACTION_INBOX_HPP
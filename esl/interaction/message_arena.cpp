@@ -0,0 +1,218 @@
+/// \file   message_arena.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <esl/interaction/message_arena.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+
+
+namespace esl::interaction {
+
+    namespace {
+        struct block
+        {
+            block *next;
+        };
+
+        struct free_list
+        {
+            block *head = nullptr;
+            size_t size = 0;
+
+            void push(block *b)
+            {
+                b->next = head;
+                head    = b;
+                ++size;
+            }
+
+            block *pop()
+            {
+                auto *result_ = head;
+                head = result_->next;
+                --size;
+                return result_;
+            }
+
+            ///
+            /// \brief  Moves all blocks of `other` to this list.
+            ///
+            void splice(free_list &other)
+            {
+                if(nullptr == other.head) {
+                    return;
+                }
+                auto *last_ = other.head;
+                while(nullptr != last_->next) {
+                    last_ = last_->next;
+                }
+                last_->next = head;
+                head        = other.head;
+                size       += other.size;
+                other       = free_list();
+            }
+        };
+
+        ///
+        /// \brief  Blocks shared between threads. This is never destroyed,
+        ///         so that messages held by static objects can be freed
+        ///         after all threads have exited.
+        ///
+        struct shared_state
+        {
+            std::mutex mutex;
+            std::array<free_list, message_arena::classes> free;
+            std::atomic<std::uint64_t> chunks    = 0;
+            std::atomic<std::uint64_t> oversized = 0;
+
+            ///
+            /// \brief  Carves a new chunk into blocks of one size class.
+            ///         The caller holds the mutex.
+            ///
+            void carve(size_t size_class)
+            {
+                const size_t block_ = (size_class + 1) * message_arena::granularity;
+                auto *chunk_ = static_cast<char *>(::operator new(
+                    message_arena::chunk_size,
+                    std::align_val_t(message_arena::granularity)));
+                for(size_t o = 0; o + block_ <= message_arena::chunk_size; o += block_) {
+                    free[size_class].push(reinterpret_cast<block *>(chunk_ + o));
+                }
+                ++chunks;
+            }
+        };
+
+        shared_state &shared()
+        {
+            static auto *state_ = new shared_state();
+            return *state_;
+        }
+
+        thread_local bool exited_ = false;
+
+        struct thread_cache
+        {
+            std::array<free_list, message_arena::classes> free;
+
+            ~thread_cache()
+            {
+                exited_ = true;
+                auto &shared_ = shared();
+                std::lock_guard lock_(shared_.mutex);
+                for(size_t c = 0; c < free.size(); ++c) {
+                    shared_.free[c].splice(free[c]);
+                }
+            }
+        };
+
+        ///
+        /// \return The calling thread's cache, or nullptr once the thread is
+        ///         exiting.
+        ///
+        thread_cache *local()
+        {
+            if(exited_) {
+                return nullptr;
+            }
+            thread_local thread_cache cache_;
+            return &cache_;
+        }
+
+        constexpr size_t size_class(size_t bytes)
+        {
+            return (std::max<size_t>(1, bytes) + message_arena::granularity - 1)
+                 / message_arena::granularity - 1;
+        }
+    }  // namespace
+
+    void *message_arena::allocate(size_t bytes)
+    {
+        const auto class_ = size_class(bytes);
+        if(classes <= class_) {
+            ++shared().oversized;
+            return ::operator new(bytes);
+        }
+
+        auto *cache_ = local();
+        if(nullptr != cache_ && nullptr != cache_->free[class_].head) {
+            return cache_->free[class_].pop();
+        }
+
+        auto &shared_ = shared();
+        std::lock_guard lock_(shared_.mutex);
+        if(nullptr == shared_.free[class_].head) {
+            shared_.carve(class_);
+        }
+        if(nullptr == cache_) {
+            return shared_.free[class_].pop();
+        }
+        cache_->free[class_].splice(shared_.free[class_]);
+        return cache_->free[class_].pop();
+    }
+
+    void message_arena::deallocate(void *pointer, size_t bytes) noexcept
+    {
+        const auto class_ = size_class(bytes);
+        if(classes <= class_) {
+            ::operator delete(pointer);
+            return;
+        }
+
+        auto *block_ = static_cast<block *>(pointer);
+        auto *cache_ = local();
+        if(nullptr == cache_) {
+            auto &shared_ = shared();
+            std::lock_guard lock_(shared_.mutex);
+            shared_.free[class_].push(block_);
+            return;
+        }
+
+        auto &list_ = cache_->free[class_];
+        list_.push(block_);
+
+        // a thread that frees more than it allocates, for example because it
+        // runs the recipients of messages created elsewhere, returns half of
+        // its blocks once it holds more than two chunks worth
+        const size_t limit_ = 2 * chunk_size / ((class_ + 1) * granularity);
+        if(list_.size > limit_) {
+            free_list half_;
+            for(size_t i = 0; i < limit_ / 2; ++i) {
+                half_.push(list_.pop());
+            }
+            auto &shared_ = shared();
+            std::lock_guard lock_(shared_.mutex);
+            shared_.free[class_].splice(half_);
+        }
+    }
+
+    message_arena::statistics_t message_arena::statistics()
+    {
+        auto &shared_ = shared();
+        return {shared_.chunks.load(), shared_.oversized.load()};
+    }
+
+}  // namespace esl::interaction
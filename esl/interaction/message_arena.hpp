@@ -0,0 +1,150 @@
+/// \file   message_arena.hpp
+///
+/// \brief  Pooled storage for messages
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_INTERACTION_MESSAGE_ARENA_HPP
+#define ESL_INTERACTION_MESSAGE_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+
+namespace esl::interaction {
+
+    ///
+    /// \brief  Process-wide pool for message memory.
+    ///
+    /// \details    Messages are short-lived and all have one of a few sizes,
+    ///             so memory is kept in free lists per size class of
+    ///             `granularity` bytes, carved from large chunks. Each thread
+    ///             allocates from and frees to its own free lists without
+    ///             locks. A message freed by another thread than the one
+    ///             that created it (for example, by the recipient) is reused
+    ///             by the freeing thread. A thread that accumulates more
+    ///             free blocks than it uses returns half of them to a shared
+    ///             list, which other threads take from before they carve new
+    ///             chunks. Once all threads have seen their largest number
+    ///             of messages in flight, no more memory is requested from
+    ///             the system.
+    ///
+    ///             Messages that are kept for longer simply keep their
+    ///             block, so there is no step at which they must be copied
+    ///             out. Chunks are never returned to the system.
+    ///
+    class message_arena
+    {
+    public:
+        ///
+        /// \brief  Size classes are multiples of this, which is also the
+        ///         alignment of all blocks.
+        ///
+        constexpr static size_t granularity = 16;
+
+        ///
+        /// \brief  Number of size classes. Larger allocations go to the
+        ///         global allocator.
+        ///
+        constexpr static size_t classes = 32;
+
+        ///
+        /// \brief  Size of the chunks from which blocks are carved.
+        ///
+        constexpr static size_t chunk_size = 64 * 1024;
+
+        ///
+        /// \brief  Counters since the start of the process.
+        ///
+        struct statistics_t
+        {
+            ///
+            /// \brief  Chunks requested from the system
+            ///
+            std::uint64_t chunks;
+
+            ///
+            /// \brief  Allocations too large for a size class
+            ///
+            std::uint64_t oversized;
+        };
+
+        [[nodiscard]] static void *allocate(size_t bytes);
+
+        static void deallocate(void *pointer, size_t bytes) noexcept;
+
+        [[nodiscard]] static statistics_t statistics();
+
+        ///
+        /// \brief  Standard allocator that uses the arena, used with
+        ///         `std::allocate_shared` so that the message and its
+        ///         reference count share one block.
+        ///
+        template<typename value_t_>
+        struct allocator
+        {
+            typedef value_t_ value_type;
+
+            allocator() noexcept = default;
+
+            template<typename other_t_>
+            allocator(const allocator<other_t_> &) noexcept
+            {
+
+            }
+
+            [[nodiscard]] value_t_ *allocate(size_t n)
+            {
+                if constexpr(alignof(value_t_) > granularity) {
+                    return static_cast<value_t_ *>(::operator new(
+                        n * sizeof(value_t_), std::align_val_t(alignof(value_t_))));
+                }
+                return static_cast<value_t_ *>(
+                    message_arena::allocate(n * sizeof(value_t_)));
+            }
+
+            void deallocate(value_t_ *pointer, size_t n) noexcept
+            {
+                if constexpr(alignof(value_t_) > granularity) {
+                    ::operator delete(pointer, std::align_val_t(alignof(value_t_)));
+                    return;
+                }
+                message_arena::deallocate(pointer, n * sizeof(value_t_));
+            }
+
+            template<typename other_t_>
+            constexpr bool operator == (const allocator<other_t_> &) const noexcept
+            {
+                return true;
+            }
+
+            template<typename other_t_>
+            constexpr bool operator != (const allocator<other_t_> &) const noexcept
+            {
+                return false;
+            }
+        };
+    };
+
+}  // namespace esl::interaction
+
+#endif  // ESL_INTERACTION_MESSAGE_ARENA_HPP
@@ -0,0 +1,152 @@
+/// \file   message_codec.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <esl/interaction/message_codec.hpp>
+
+#include <istream>
+#include <ostream>
+#include <streambuf>
+
+#include <boost/archive/archive_exception.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include <esl/exception.hpp>
+
+
+namespace esl::interaction {
+
+    namespace {
+        constexpr auto archive_flags_ =
+            boost::archive::no_header | boost::archive::no_codecvt;
+
+        ///
+        /// \brief  Appends everything written to a string.
+        ///
+        struct append_buffer
+        : public std::streambuf
+        {
+            std::string &target;
+
+            explicit append_buffer(std::string &target)
+            : target(target)
+            {
+
+            }
+
+            int_type overflow(int_type c) override
+            {
+                if(!traits_type::eq_int_type(c, traits_type::eof())) {
+                    target.push_back(traits_type::to_char_type(c));
+                }
+                return traits_type::not_eof(c);
+            }
+
+            std::streamsize xsputn(const char *s, std::streamsize n) override
+            {
+                target.append(s, size_t(n));
+                return n;
+            }
+        };
+
+        ///
+        /// \brief  Reads from memory without copying it.
+        ///
+        struct memory_buffer
+        : public std::streambuf
+        {
+            memory_buffer(const char *data, size_t size)
+            {
+                auto *begin_ = const_cast<char *>(data);
+                setg(begin_, begin_, begin_ + size);
+            }
+        };
+    }  // namespace
+
+    std::unordered_map<message_code, message_codec::entry> &message_codec::registry()
+    {
+        static std::unordered_map<message_code, entry> registry_;
+        return registry_;
+    }
+
+    bool message_codec::registered(message_code code)
+    {
+        return registry().end() != registry().find(code);
+    }
+
+    void message_codec::encode(const std::vector<std::shared_ptr<header>> &messages,
+                               std::string &buffer)
+    {
+        append_buffer buffer_(buffer);
+        std::ostream stream_(&buffer_);
+        boost::archive::binary_oarchive archive_(stream_, archive_flags_);
+
+        std::uint64_t count_ = messages.size();
+        archive_ << count_;
+        for(const auto &m : messages) {
+            archive_ << m->type;
+            auto iterator_ = registry().find(m->type);
+            if(registry().end() != iterator_) {
+                iterator_->second.save(archive_, *m);
+                continue;
+            }
+            // other messages are written with their exported class name
+            try {
+                archive_ << m;
+            } catch(const boost::archive::archive_exception &e) {
+                if(boost::archive::archive_exception::unregistered_class != e.code) {
+                    throw;
+                }
+                throw esl::exception("message type "
+                                     + std::to_string(m->type)
+                                     + " is neither registered with the"
+                                       " message_codec nor exported");
+            }
+        }
+    }
+
+    size_t message_codec::decode(const char *data, size_t size,
+                                 const std::function<void(std::shared_ptr<header>)> &deliver)
+    {
+        memory_buffer buffer_(data, size);
+        std::istream stream_(&buffer_);
+        boost::archive::binary_iarchive archive_(stream_, archive_flags_);
+
+        std::uint64_t count_ = 0;
+        archive_ >> count_;
+        for(std::uint64_t i = 0; i < count_; ++i) {
+            message_code type_;
+            archive_ >> type_;
+            auto iterator_ = registry().find(type_);
+            if(registry().end() != iterator_) {
+                deliver(iterator_->second.load(archive_));
+                continue;
+            }
+            std::shared_ptr<header> message_;
+            archive_ >> message_;
+            deliver(std::move(message_));
+        }
+        return size_t(count_);
+    }
+
+}  // namespace esl::interaction
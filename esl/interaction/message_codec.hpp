@@ -0,0 +1,126 @@
+/// \file   message_codec.hpp
+///
+/// \brief  Serialization of messages by their message code
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_INTERACTION_MESSAGE_CODEC_HPP
+#define ESL_INTERACTION_MESSAGE_CODEC_HPP
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <esl/interaction/header.hpp>
+#include <esl/interaction/message_arena.hpp>
+
+
+namespace esl::interaction {
+
+    ///
+    /// \brief  Writes messages of registered types to a byte buffer, and
+    ///         reads them back as their concrete type.
+    ///
+    /// \details    Message types are identified by their `message_code`,
+    ///             which is written before each message, so that no class
+    ///             names need to be exported. Message types that are sent
+    ///             between processes are registered, on every process,
+    ///             before the model runs:
+    ///
+    ///                 static const bool registered_ =
+    ///                     message_codec::register_message<my_message>();
+    ///
+    ///             The library registers its own message types. Messages of
+    ///             types that are not registered are written as polymorphic
+    ///             pointers, which requires their type to be exported using
+    ///             BOOST_CLASS_EXPORT.
+    ///
+    class message_codec
+    {
+    public:
+        typedef std::function<void(boost::archive::binary_oarchive &,
+                                   const header &)> save_t;
+
+        typedef std::function<std::shared_ptr<header>(
+            boost::archive::binary_iarchive &)> load_t;
+
+    private:
+        struct entry
+        {
+            save_t save;
+            load_t load;
+        };
+
+        static std::unordered_map<message_code, entry> &registry();
+
+    public:
+        ///
+        /// \brief  Registers the message type under its code.
+        ///
+        /// \return true, so that registration can initialise a static
+        ///
+        template<typename message_type_>
+        static bool register_message()
+        {
+            static_assert(std::is_base_of<header, message_type_>::value);
+            registry()[message_type_::code] =
+                { [](boost::archive::binary_oarchive &archive, const header &h) {
+                      archive << static_cast<const message_type_ &>(h);
+                  }
+                , [](boost::archive::binary_iarchive &archive) {
+                      auto result_ = std::allocate_shared<message_type_>(
+                          message_arena::allocator<message_type_>());
+                      archive >> *result_;
+                      return std::shared_ptr<header>(std::move(result_));
+                  }
+                };
+            return true;
+        }
+
+        [[nodiscard]] static bool registered(message_code code);
+
+        ///
+        /// \brief  Appends the messages to `buffer`, in order.
+        ///
+        /// \throws esl::exception if a message type is neither registered
+        ///         nor exported
+        ///
+        static void encode(const std::vector<std::shared_ptr<header>> &messages,
+                           std::string &buffer);
+
+        ///
+        /// \brief  Reads the messages in `data`, and passes each to `deliver`
+        ///         in the order they were encoded.
+        ///
+        /// \return The number of messages read
+        ///
+        static size_t decode(const char *data, size_t size,
+                             const std::function<void(std::shared_ptr<header>)> &deliver);
+    };
+
+}  // namespace esl::interaction
+
+#endif  // ESL_INTERACTION_MESSAGE_CODEC_HPP
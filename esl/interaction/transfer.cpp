@@ -30,6 +30,13 @@
 #include <boost/serialization/export.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 
+#include <esl/interaction/message_codec.hpp>
+
 //BOOST_CLASS_EXPORT(esl::interaction::transfer)
 
+namespace esl::interaction {
+    static const bool transfer_registered_ =
+        message_codec::register_message<transfer>();
+}  // namespace esl::interaction
+
 
@@ -28,6 +28,10 @@
 #ifndef ESL_TRANSFER_HPP
 #define ESL_TRANSFER_HPP
 
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/unordered_map.hpp>
+
 #include <esl/economics/accounting/inventory.hpp>
 #include <esl/interaction/header.hpp>
 #include <esl/interaction/message.hpp>
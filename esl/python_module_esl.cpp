@@ -369,6 +369,7 @@ void translate_exception(const exception &e)
 #include <esl/computation/python_module_computation.hpp>
 #include <esl/computation/block_pool.hpp>
 #include <esl/computation/environment.hpp>
+#include <esl/computation/random.hpp>
 #include <esl/computation/timing.hpp>
 using namespace esl::computation;
 
@@ -1413,6 +1414,10 @@ BOOST_PYTHON_MODULE(_esl)
             )
             .def("create", &create_identity<agent>)
 
+            .add_property("rng"
+                , make_function(+[](python_agent &a) -> computation::random_stream & { return a.rng; }
+                               , return_internal_reference<>())
+                )
             ;
 
 
@@ -1432,6 +1437,15 @@ BOOST_PYTHON_MODULE(_esl)
             .def_readwrite("index",
                            &computation::block_pool::block<object>::index);
 
+        class_<computation::random_stream>(
+            "random_stream", "Counter-based random numbers, keyed by sample, entity, time point and round.",
+            init<>())
+            .def(init<std::uint64_t, std::uint64_t, std::uint64_t, std::uint32_t>())
+            .def("__call__", &computation::random_stream::operator ())
+            .def("next64", &computation::random_stream::next64)
+            .def("uniform", &computation::random_stream::uniform)
+            .def("discard", &computation::random_stream::discard);
+
         // computational environment base class with default single thread
         class_<python_environment, boost::noncopyable>(
             "environment", "The environment class runs models: it schedules agents and delivers messages sent between agents.")
@@ -1906,7 +1920,8 @@ BOOST_PYTHON_MODULE(_esl)
                     .value("invalid", execution_report::state_t::invalid)
                     .value("cancel", execution_report::state_t::cancel)
                     .value("match", execution_report::state_t::match)
-                    .value("placement", execution_report::state_t::placement);
+                    .value("placement", execution_report::state_t::placement)
+                    .value("resize", execution_report::state_t::resize);
 
                 class_<execution_report>("execution_report"
                                          , init<execution_report::state_t
@@ -1971,7 +1986,7 @@ BOOST_PYTHON_MODULE(_esl)
                     .def("display", &basic_book::display);
 
                 //
-                class_<static_order_book, bases<basic_book>>
+                class_<static_order_book, bases<basic_book>, boost::noncopyable>
                     ( "static_order_book"
                     , "Limit order book optimized for fast throughput. Uses statically allocated memory pool."
                     , init<quote, quote, size_t>())
@@ -2723,7 +2738,13 @@ BOOST_PYTHON_MODULE(_esl)
 
         class_<python_identity>("identity")
             .def("__init__", make_constructor(convert_digit_list_generic<python_identity>))
-            .def_readonly("digits", &python_identity::digits)
+            .add_property("digits", +[](const python_identity &i) {
+                boost::python::list result_;
+                for(auto d : i.digits) {
+                    result_.append(d);
+                }
+                return result_;
+            })
             .def("__str__", &python_identity::representation,
                  python_identity_representation_overload(args("width"), ""))
             .def("__repr__", &python_identity::representation,
@@ -24,6 +24,10 @@
 ///
 #include <esl/simulation/agent_collection.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+
 #include <esl/agent.hpp>
 
 #include <esl/computation/environment.hpp>
@@ -40,17 +44,247 @@ namespace esl::simulation {
     void agent_collection::activate(std::shared_ptr<agent> a)
     {
         global_agents_.insert(a->identifier);
-        local_agents_.insert({a->identifier, a});
+        insert_local(a);
         environment_.get().activate_agent(a->identifier);
     }
 
     void agent_collection::deactivate(std::shared_ptr<agent> a)
     {
         global_agents_.erase(a->identifier);
-        local_agents_.erase(a->identifier);
+        erase_local(a->identifier);
         environment_.get().deactivate_agent(a->identifier);
     }
 
+    bool agent_collection::insert_slot(std::shared_ptr<agent> a)
+    {
+        if(!local_agents_.insert({a->identifier, a}).second) {
+            return false;
+        }
+
+        agent_handle h;
+        if(free_.empty()) {
+            h = agent_handle(slots_.size());
+            slots_.push_back(a.get());
+        }else{
+            h = free_.back();
+            free_.pop_back();
+            slots_[h] = a.get();
+        }
+        a->handle_ = h;
+        index_insert(h);
+
+        // also for agents that migrated here or were restored
+        if(interaction::inbox::bucketed == inbox_storage){
+            a->inbox.use(inbox_storage);
+        }
+        return true;
+    }
+
+    void agent_collection::insert_local(std::shared_ptr<agent> a)
+    {
+        if(!insert_slot(a)) {
+            return;
+        }
+
+        if(event_driven){
+            if(agent::every_round == a->activation){
+                polled_.push_back(a.get());
+            }else{
+                // new and migrated agents get a first round, in which they
+                // can schedule their own events
+                wake(a.get());
+            }
+        }
+    }
+
+    void agent_collection::restore(std::shared_ptr<agent> a, bool woken)
+    {
+        global_agents_.insert(a->identifier);
+        if(!insert_slot(a)) {
+            return;
+        }
+
+        if(event_driven){
+            if(agent::every_round == a->activation){
+                polled_.push_back(a.get());
+                return;
+            }
+            schedule(a.get());
+            if(woken){
+                wake(a.get());
+            }
+        }
+    }
+
+    bool agent_collection::woken(const agent &a) const
+    {
+        return a.wakeup_.queued;
+    }
+
+    void agent_collection::erase_local(const identity<agent> &i)
+    {
+        auto iterator_ = local_agents_.find(i);
+        if(local_agents_.end() == iterator_) {
+            return;
+        }
+        auto *a = iterator_->second.get();
+        if(event_driven){
+            // drop all references, so that no dangling pointer is left once
+            // the agent is destroyed or has migrated
+            polled_.erase(std::remove(polled_.begin(), polled_.end(), a)
+                         , polled_.end());
+            woken_.erase(std::remove(woken_.begin(), woken_.end(), a)
+                        , woken_.end());
+            auto stale_ = std::remove_if(calendar_.begin(), calendar_.end()
+                , [a](const auto &e){ return e.second == a; });
+            if(stale_ != calendar_.end()){
+                calendar_.erase(stale_, calendar_.end());
+                std::make_heap(calendar_.begin(), calendar_.end()
+                              , std::greater<>());
+            }
+        }
+        index_erase(i);
+        slots_[a->handle_] = nullptr;
+        free_.push_back(a->handle_);
+        a->handle_ = invalid_handle;
+        local_agents_.erase(iterator_);
+    }
+
+    void agent_collection::clear_local()
+    {
+        for(auto *a : slots_) {
+            if(nullptr != a) {
+                a->handle_ = invalid_handle;
+            }
+        }
+        slots_.clear();
+        free_.clear();
+        index_.clear();
+        index_used_ = 0;
+        calendar_.clear();
+        woken_.clear();
+        polled_.clear();
+        local_agents_.clear();
+    }
+
+    void agent_collection::index_insert(agent_handle h)
+    {
+        // keep the load, including removed entries, at most one half
+        if(index_.size() < 2 * (index_used_ + 1)) {
+            std::vector<agent_handle> previous_;
+            previous_.swap(index_);
+            size_t capacity_ = 16;
+            while(capacity_ < 4 * local_agents_.size()) {
+                capacity_ *= 2;
+            }
+            index_.assign(capacity_, invalid_handle);
+            index_used_ = 0;
+            for(auto p : previous_) {
+                if(invalid_handle != p && removed_ != p) {
+                    index_insert(p);
+                }
+            }
+        }
+
+        const size_t mask_ = index_.size() - 1;
+        auto i = slots_[h]->identifier.digits.hash() & mask_;
+        while(invalid_handle != index_[i] && removed_ != index_[i]) {
+            i = (i + 1) & mask_;
+        }
+        if(invalid_handle == index_[i]) {
+            ++index_used_;
+        }
+        index_[i] = h;
+    }
+
+    void agent_collection::index_erase(const identity<agent> &identifier)
+    {
+        if(index_.empty()) {
+            return;
+        }
+        const size_t mask_ = index_.size() - 1;
+        for(auto i = identifier.digits.hash() & mask_; invalid_handle != index_[i];
+            i = (i + 1) & mask_) {
+            if(removed_ != index_[i] && slots_[index_[i]]->identifier == identifier) {
+                index_[i] = removed_;
+                return;
+            }
+        }
+    }
+
+    agent_handle agent_collection::handle(const identity<agent> &identifier) const
+    {
+        if(index_.empty()) {
+            return invalid_handle;
+        }
+        const size_t mask_ = index_.size() - 1;
+        for(auto i = identifier.digits.hash() & mask_; invalid_handle != index_[i];
+            i = (i + 1) & mask_) {
+            if(removed_ != index_[i] && slots_[index_[i]]->identifier == identifier) {
+                return index_[i];
+            }
+        }
+        return invalid_handle;
+    }
+
+    agent *agent_collection::find(const identity<agent> &identifier) const
+    {
+        auto h = handle(identifier);
+        return invalid_handle == h ? nullptr : slots_[h];
+    }
+
+    void agent_collection::wake(agent *a)
+    {
+        if(a->wakeup_.queued || agent::every_round == a->activation){
+            return;
+        }
+        a->wakeup_.queued = true;
+        woken_.push_back(a);
+    }
+
+    void agent_collection::schedule(agent *a)
+    {
+        a->wakeup_.queued = false;
+        if(agent::every_round == a->activation
+           || std::numeric_limits<time_point>::max() == a->wakeup_.scheduled){
+            return;
+        }
+        calendar_.emplace_back(a->wakeup_.scheduled, a);
+        std::push_heap(calendar_.begin(), calendar_.end(), std::greater<>());
+    }
+
+    void agent_collection::due(time_point now, std::vector<agent *> &out)
+    {
+        out.insert(out.end(), polled_.begin(), polled_.end());
+        // woken agents are already marked as queued
+        out.insert(out.end(), woken_.begin(), woken_.end());
+        woken_.clear();
+
+        while(!calendar_.empty() && calendar_.front().first <= now){
+            std::pop_heap(calendar_.begin(), calendar_.end(), std::greater<>());
+            auto [t, a] = calendar_.back();
+            calendar_.pop_back();
+            if(t != a->wakeup_.scheduled || a->wakeup_.queued){
+                continue;
+            }
+            a->wakeup_.queued = true;
+            out.push_back(a);
+        }
+    }
+
+    time_point agent_collection::next_event()
+    {
+        while(!calendar_.empty()){
+            auto [t, a] = calendar_.front();
+            if(t == a->wakeup_.scheduled){
+                return t;
+            }
+            std::pop_heap(calendar_.begin(), calendar_.end(), std::greater<>());
+            calendar_.pop_back();
+        }
+        return std::numeric_limits<time_point>::max();
+    }
+
     std::shared_ptr<agent>
         agent_collection::operator[](const identity<agent> &a)
     {
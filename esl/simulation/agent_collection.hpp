@@ -28,8 +28,13 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include <esl/interaction/inbox.hpp>
+#include <esl/simulation/agent_handle.hpp>
 #include <esl/simulation/identity.hpp>
+#include <esl/simulation/time.hpp>
 
 
 namespace esl {
@@ -49,6 +54,62 @@ namespace esl::simulation {
     protected:
         std::reference_wrapper<computation::environment> environment_;
 
+        ///
+        /// \brief  The local agents, indexed by handle. Slots of removed
+        ///         agents are nullptr until their handle is reused.
+        ///
+        std::vector<agent *> slots_;
+
+        ///
+        /// \brief  Handles of empty slots, reused most recent first.
+        ///
+        std::vector<agent_handle> free_;
+
+        ///
+        /// \brief  Open addressing hash index from identity to handle, using
+        ///         the identity's cached hash and linear probing. Its size is
+        ///         a power of two.
+        ///
+        std::vector<agent_handle> index_;
+
+        ///
+        /// \brief  Marks index entries of removed agents.
+        ///
+        constexpr static agent_handle removed_ = invalid_handle - 1;
+
+        ///
+        /// \brief  Occupied and removed entries in `index_`.
+        ///
+        size_t index_used_ = 0;
+
+        void index_insert(agent_handle h);
+
+        void index_erase(const identity<agent> &i);
+
+        ///
+        /// \brief  Gives the agent a slot and a handle, and switches its
+        ///         inbox to `inbox_storage`.
+        ///
+        /// \return False if the agent was already local
+        bool insert_slot(std::shared_ptr<agent> a);
+
+        ///
+        /// \brief  Min-heap of (time, agent) wake-up events. Entries whose
+        ///         time no longer matches the agent's scheduled time are
+        ///         stale and are discarded when they reach the top.
+        ///
+        std::vector<std::pair<time_point, agent *>> calendar_;
+
+        ///
+        /// \brief  Agents that received messages since they last ran.
+        ///
+        std::vector<agent *> woken_;
+
+        ///
+        /// \brief  Agents with the `every_round` activation policy.
+        ///
+        std::vector<agent *> polled_;
+
         ///
         /// \brief  The identities of all agents in the simulation.
         ///
@@ -88,6 +149,101 @@ namespace esl::simulation {
 
         void deactivate(std::shared_ptr<agent> a);
 
+        ///
+        /// \brief  Adds the agent to the local agents and gives it a handle,
+        ///         without notifying the environment. Used when agents
+        ///         migrate between processes.
+        ///
+        void insert_local(std::shared_ptr<agent> a);
+
+        ///
+        /// \brief  Adds an agent restored from a checkpoint to the local
+        ///         agents, with the next event it had when it was saved,
+        ///         without notifying the environment.
+        ///
+        /// \param woken    Whether the agent was woken by messages
+        void restore(std::shared_ptr<agent> a, bool woken);
+
+        ///
+        /// \return True if the agent received messages since it last ran,
+        ///         and runs in the next round
+        bool woken(const agent &a) const;
+
+        ///
+        /// \brief  Removes the agent from the local agents and frees its
+        ///         handle, without notifying the environment.
+        ///
+        void erase_local(const identity<agent> &i);
+
+        ///
+        /// \brief  Removes all local agents.
+        ///
+        void clear_local();
+
+        ///
+        /// \return The local agent with the identity, or nullptr
+        ///
+        agent *find(const identity<agent> &i) const;
+
+        ///
+        /// \return The handle of the local agent, or `invalid_handle`
+        ///
+        agent_handle handle(const identity<agent> &i) const;
+
+        ///
+        /// \return The agent with the handle, or nullptr if the slot is empty
+        ///
+        agent *get(agent_handle h) const
+        {
+            return h < slots_.size() ? slots_[h] : nullptr;
+        }
+
+        ///
+        /// \brief  All slots, indexed by handle. Empty slots are nullptr.
+        ///
+        const std::vector<agent *> &slots() const
+        {
+            return slots_;
+        }
+
+        ///
+        /// \brief  When set, the collection maintains the wake-up index used
+        ///         by models that activate agents by event. Must be set
+        ///         before agents are created.
+        ///
+        bool event_driven = false;
+
+        ///
+        /// \brief  When `bucketed`, all agents use bucketed inboxes. When
+        ///         `ordered`, agents keep the storage they chose themselves.
+        ///         Must be set before agents are created.
+        ///
+        interaction::inbox::storage_t inbox_storage = interaction::inbox::ordered;
+
+        ///
+        /// \brief  Marks the agent to run in the next round, because it has
+        ///         received messages. Not thread-safe.
+        ///
+        void wake(agent *a);
+
+        ///
+        /// \brief  Files the agent under the next event it asked for, after
+        ///         it has run.
+        ///
+        void schedule(agent *a);
+
+        ///
+        /// \brief  Appends the agents due to run at time `now` to `out`, each
+        ///         agent once, and removes their wake-up events.
+        ///
+        void due(time_point now, std::vector<agent *> &out);
+
+        ///
+        /// \brief  The earliest scheduled wake-up event, or the maximum
+        ///         time_point when no agent is waiting.
+        ///
+        time_point next_event();
+
         std::shared_ptr<agent> operator[](const identity<agent> &a);
     };
 }  // namespace esl::simulation
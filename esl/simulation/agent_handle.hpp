@@ -0,0 +1,46 @@
+/// \file   agent_handle.hpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_SIMULATION_AGENT_HANDLE_HPP
+#define ESL_SIMULATION_AGENT_HANDLE_HPP
+
+#include <cstdint>
+#include <limits>
+
+
+namespace esl::simulation {
+    ///
+    /// \brief  Dense index of an agent in its local agent collection.
+    ///
+    typedef std::uint32_t agent_handle;
+
+    ///
+    /// \brief  The handle of agents that are not in a local collection.
+    ///
+    constexpr agent_handle invalid_handle =
+        std::numeric_limits<agent_handle>::max();
+
+}  // namespace esl::simulation
+
+#endif  // ESL_SIMULATION_AGENT_HANDLE_HPP
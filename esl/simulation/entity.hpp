@@ -117,11 +117,9 @@ namespace esl {
         template<typename child_t_>
         identity<child_t_> create()
         {
-            auto prefix_ = std::vector<std::uint64_t>(identifier.digits);
-            prefix_.push_back(children_);
+            auto child_ = identifier.digits.append(children_);
             ++children_;
-            prefix_.shrink_to_fit();
-            return identity<child_t_>(move(prefix_));
+            return identity<child_t_>(std::move(child_));
         }
 
 
@@ -28,15 +28,19 @@
 
 #include <algorithm>  // TODO: use this when C++20 support is widespread
 #include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 // using std::lexicographical_compare_3way;
 
 #include <boost/functional/hash.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <boost/serialization/vector.hpp>
 
 
@@ -59,6 +63,236 @@
 
 namespace esl {
 
+    ///
+    /// \brief  The immutable digits of an identity, with their hash computed
+    ///         once.
+    ///
+    /// \details    Up to `inline_capacity` digits are stored in the object
+    ///             itself, so that copying the identities of shallow entity
+    ///             hierarchies does not allocate. Longer sequences are
+    ///             stored on the heap.
+    ///
+    class identity_digits
+    {
+    public:
+        typedef std::uint64_t value_type;
+
+        typedef std::size_t size_type;
+
+        typedef const value_type *const_iterator;
+
+        typedef const_iterator iterator;
+
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        typedef const_reverse_iterator reverse_iterator;
+
+        constexpr static size_type inline_capacity = 4;
+
+    private:
+        size_type size_;
+
+        std::size_t hash_;
+
+        union
+        {
+            value_type inline_[inline_capacity];
+            value_type *heap_;
+        };
+
+        ///
+        /// \brief  Sets the size and returns the storage for the digits,
+        ///         which must be empty.
+        ///
+        value_type *allocate(size_type size)
+        {
+            size_ = size;
+            if(inline_capacity < size) {
+                heap_ = new value_type[size];
+                return heap_;
+            }
+            return inline_;
+        }
+
+        ///
+        /// \brief  Much like boost::hash_range, this combines all digits, with
+        ///         the difference being that the hash of a one-digit identity
+        ///         is that digit itself.
+        ///
+        void rehash()
+        {
+            hash_ = 0;
+            if(0 < size_) {
+                auto *digits_ = data();
+                hash_ = std::size_t(digits_[size_ - 1]);
+                for(size_type i = size_ - 1; 0 < i; --i) {
+                    boost::hash_combine(hash_, digits_[i - 1]);
+                }
+            }
+        }
+
+        void release()
+        {
+            if(inline_capacity < size_) {
+                delete[] heap_;
+            }
+            size_ = 0;
+        }
+
+    public:
+        identity_digits() noexcept
+        : size_(0)
+        , hash_(0)
+        , inline_{}
+        {
+
+        }
+
+        identity_digits(const value_type *first, size_type size)
+        : identity_digits()
+        {
+            if(0 < size) {
+                std::memcpy(allocate(size), first, size * sizeof(value_type));
+            }
+            rehash();
+        }
+
+        identity_digits(const std::vector<value_type> &digits)
+        : identity_digits(digits.data(), digits.size())
+        {
+
+        }
+
+        identity_digits(std::initializer_list<value_type> digits)
+        : identity_digits(digits.begin(), digits.size())
+        {
+
+        }
+
+        identity_digits(const identity_digits &o)
+        : identity_digits(o.data(), o.size_)
+        {
+
+        }
+
+        identity_digits(identity_digits &&o) noexcept
+        : size_(o.size_)
+        , hash_(o.hash_)
+        {
+            if(inline_capacity < size_) {
+                heap_ = o.heap_;
+            }else{
+                std::copy(o.inline_, o.inline_ + size_, inline_);
+            }
+            o.size_ = 0;
+            o.hash_ = 0;
+        }
+
+        ~identity_digits()
+        {
+            release();
+        }
+
+        identity_digits &operator = (const identity_digits &o)
+        {
+            if(this != &o) {
+                identity_digits copy_(o);
+                *this = std::move(copy_);
+            }
+            return *this;
+        }
+
+        identity_digits &operator = (identity_digits &&o) noexcept
+        {
+            if(this != &o) {
+                release();
+                size_ = o.size_;
+                hash_ = o.hash_;
+                if(inline_capacity < size_) {
+                    heap_ = o.heap_;
+                }else{
+                    std::copy(o.inline_, o.inline_ + size_, inline_);
+                }
+                o.size_ = 0;
+                o.hash_ = 0;
+            }
+            return *this;
+        }
+
+        [[nodiscard]] const value_type *data() const
+        {
+            return inline_capacity < size_ ? heap_ : inline_;
+        }
+
+        [[nodiscard]] size_type size() const
+        {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return 0 == size_;
+        }
+
+        [[nodiscard]] const_iterator begin() const
+        {
+            return data();
+        }
+
+        [[nodiscard]] const_iterator end() const
+        {
+            return data() + size_;
+        }
+
+        [[nodiscard]] const_reverse_iterator rbegin() const
+        {
+            return const_reverse_iterator(end());
+        }
+
+        [[nodiscard]] const_reverse_iterator rend() const
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        [[nodiscard]] const value_type &operator [] (size_type i) const
+        {
+            return data()[i];
+        }
+
+        [[nodiscard]] const value_type &front() const
+        {
+            return data()[0];
+        }
+
+        [[nodiscard]] const value_type &back() const
+        {
+            return data()[size_ - 1];
+        }
+
+        [[nodiscard]] constexpr std::size_t hash() const
+        {
+            return hash_;
+        }
+
+        ///
+        /// \brief  Creates the digits of a child, by appending `digit`.
+        ///
+        [[nodiscard]] identity_digits append(value_type digit) const
+        {
+            identity_digits result_;
+            auto *destination_ = result_.allocate(size_ + 1);
+            std::copy(begin(), end(), destination_);
+            destination_[size_] = digit;
+            result_.rehash();
+            return result_;
+        }
+
+        operator std::vector<value_type>() const
+        {
+            return std::vector<value_type>(begin(), end());
+        }
+    };
+
 
     ///
     /// \brief  An identifier is a code used internally to distinguish entities.
@@ -90,18 +324,28 @@ namespace esl {
         /// \brief  The digits, elements in sequence, that make up the
         /// identifier code.
         ///
-        std::vector<digit_t> digits;
+        identity_digits digits;
 
         ///
         /// \param digits   vector of digits for the identifier, from most
         /// significant to least significant
         ///
-        constexpr explicit identity(std::vector<digit_t> &&digits = {}) noexcept
+        explicit identity(std::vector<digit_t> &&digits = {})
         : digits(digits)
         {
 
         }
 
+        ///
+        /// \param digits   digits for the identifier, from most significant to
+        ///                 least significant
+        ///
+        explicit identity(identity_digits digits) noexcept
+        : digits(std::move(digits))
+        {
+
+        }
+
         ///
         /// \param digits   vector of digits for the identifier, from most
         /// significant to least significant
@@ -160,11 +404,11 @@ namespace esl {
         ///
         /// \param i    Other identity
         ///
-        //identity(identity<identifiable_type_> &&i) noexcept
-        //: digits(i.digits)
-        //{
+        identity(identity<identifiable_type_> &&i) noexcept
+        : digits(std::move(i.digits))
+        {
 
-        //}
+        }
 
         ///
         /// \param rhs
@@ -182,7 +426,7 @@ namespace esl {
         inline identity<identifiable_type_> &
         operator=(identity<identifiable_type_> &&rhs) noexcept
         {
-            digits = (rhs.digits);
+            digits = std::move(rhs.digits);
             return *this;
         }
 
@@ -195,7 +439,11 @@ namespace esl {
         [[nodiscard]] constexpr inline bool
         operator==(const identity<identifiable_other_type_> &rhs) const
         {
-            return equal(digits.begin(),
+            // identities with different hashes can not be equal
+            if(digits.hash() != rhs.digits.hash()) {
+                return false;
+            }
+            return std::equal(digits.begin(),
                          digits.end(),
                          rhs.digits.begin(),
                          rhs.digits.end());
@@ -221,7 +469,7 @@ namespace esl {
         [[nodiscard]] constexpr inline bool
         operator<(const identity<identifiable_other_type_> &rhs) const
         {
-            return lexicographical_compare(digits.begin(),
+            return std::lexicographical_compare(digits.begin(),
                                            digits.end(),
                                            rhs.digits.begin(),
                                            rhs.digits.end());
@@ -248,7 +496,7 @@ namespace esl {
         [[nodiscard]] constexpr inline bool
         operator>(const identity<identifiable_other_type_> &rhs) const
         {
-            return lexicographical_compare(rhs.digits.begin(),
+            return std::lexicographical_compare(rhs.digits.begin(),
                                            rhs.digits.end(),
                                            digits.begin(),
                                            digits.end());
@@ -316,24 +564,37 @@ namespace esl {
         [[nodiscard]] identity<child_entity_type_>
         create(parent_type_ &parent) const
         {
-            auto prefix_ = std::vector<digit_t>(this->digits);
-            prefix_.push_back(parent.children_);
+            auto child_ = digits.append(parent.children_);
             ++parent.children_;
-            prefix_.shrink_to_fit();
-            return identity<child_entity_type_>((prefix_));
+            return identity<child_entity_type_>(std::move(child_));
         }
 
+        ///
+        /// \brief  The digits are stored as a vector, so that archives do not
+        ///         depend on the in-memory representation.
         ///
         /// \tparam archive_t
         /// \param archive
         /// \param version
         template<class archive_t>
-        void serialize(archive_t &archive, const unsigned int version)
+        void save(archive_t &archive, const unsigned int version) const
         {
             (void)version;
-            archive &BOOST_SERIALIZATION_NVP(digits);
+            std::vector<digit_t> digits_ = digits;
+            archive << boost::serialization::make_nvp("digits", digits_);
         }
 
+        template<class archive_t>
+        void load(archive_t &archive, const unsigned int version)
+        {
+            (void)version;
+            std::vector<digit_t> digits_;
+            archive >> boost::serialization::make_nvp("digits", digits_);
+            digits = identity_digits(digits_);
+        }
+
+        BOOST_SERIALIZATION_SPLIT_MEMBER()
+
 
 #ifdef WITH_PYTHON
         ///
@@ -456,37 +717,12 @@ namespace std {
         [[nodiscard]] constexpr std::size_t
         operator()(const esl::identity<entity_type_> &identifier) const
         {
-            if(identifier.digits.empty()) {
-                return 0;
-            }
-
-            std::size_t seed_ = identifier.digits.back();
-            for(auto i = identifier.digits.rbegin() + 1;
-                i != identifier.digits.rend();
-                ++i) {
-                boost::hash_combine(seed_, *i);
-            }
-
-            return seed_;
+            // computed when the identity is created
+            return identifier.digits.hash();
         }
     };
 }  // namespace std
 
 
-#ifdef WITH_MPI
-#include <boost/mpi.hpp>
-
-namespace boost::mpi {
-    ///
-    /// \brief  An identifier contains only a vector<uint64_t>
-    /// (MPI_UNSIGNED_LONG[]), which is a valid mpi data type.
-    ///
-    /// \tparam identifiable_type_
-    template<typename identifiable_type_>
-    struct is_mpi_datatype<esl::identity<identifiable_type_>> : mpl::true_
-    {};
-}  // namespace boost::mpi
-
-#endif  // WITH_MPI
 
 #endif  // ESL_SIMULATION_IDENTITY_HPP
@@ -30,15 +30,33 @@ using std::chrono::high_resolution_clock;
 
 #include <esl/agent.hpp>
 #include <esl/computation/environment.hpp>
+#include <esl/computation/profiler.hpp>
 #include <esl/data/log.hpp>
-#include <esl/quantity.hpp>
 
 
 namespace esl::simulation {
+
+    namespace {
+        ///
+        /// \brief  The `threads` parameter, where zero leaves the choice to
+        ///         the environment.
+        ///
+        unsigned int threads_parameter(const computation::environment &e
+            , const parameter::parametrization &parameters)
+        {
+            auto threads_ = parameters.get<std::uint64_t>("threads");
+            if(0 == threads_) {
+                return e.hardware_threads();
+            }
+            return static_cast<unsigned int>(threads_);
+        }
+    }
+
     model::model( computation::environment &e
         , const parameter::parametrization &parameters)
         : environment_(e)
         , rounds_(0)
+        , ranges_(threads_parameter(e, parameters))
         , parameters(parameters)
         , start(parameters.get<time_point>("start"))
         , end(parameters.get<time_point>("end"))
@@ -46,9 +64,31 @@ namespace esl::simulation {
         , sample(parameters.get<std::uint64_t>("sample"))
         , agents(e)
         , verbosity(parameters.get<std::uint64_t>("verbosity"))
-        , threads( std::max<std::uint64_t>(1, parameters.get<std::uint64_t>("threads")))
+        , threads(threads_parameter(e, parameters))
+        , scheduler(static_cast<scheduling>(parameters.get<std::uint64_t>("scheduler")))
+        , activation(static_cast<activation_mode>(parameters.get<std::uint64_t>("activation")))
     {
+        if(cost_balanced < scheduler) {
+            throw std::invalid_argument("parametrization[scheduler] is not a valid scheduler");
+        }
+
+        if(by_event < activation) {
+            throw std::invalid_argument("parametrization[activation] is not a valid activation mode");
+        }
+        auto inbox_ = parameters.get<std::uint64_t>("inbox");
+        if(interaction::inbox::bucketed < inbox_) {
+            throw std::invalid_argument("parametrization[inbox] is not a valid inbox storage");
+        }
+
+        // must be set before the derived model creates agents
+        agents.event_driven = (by_event == activation);
+        agents.inbox_storage = static_cast<interaction::inbox::storage_t>(inbox_);
 
+        // important: if using a single thread, run everything in main
+        if(1 < threads) {
+            pool_ = std::make_unique<computation::thread_pool>(threads);
+            worker_results_.resize(threads);
+        }
     }
 
     void model::initialize()
@@ -67,97 +107,202 @@ namespace esl::simulation {
         auto timer_start_ = high_resolution_clock::now();
         environment_.before_step();
 
-        // read the sample index from the parameter collection
-        std::mutex mutex_first_event_;
         time_point first_event_   = step.upper;
         unsigned int round_ = 0;
+        const bool measured_ = (cost_balanced == scheduler && pool_)
+                            || environment_.measures_agents();
         do {
             if (verbosity > 0 && 0 == (rounds_ % verbosity)){
                 LOG(notice) << "time " << step << " round " << round_  << std::endl;
             }
             first_event_   = step.upper;
 
-            auto job_ = [&](std::shared_ptr<agent> a){
-                // double agent_cb_end_;
-                // timings_.emplace(i, 0.);
-                // timings_cb_.emplace(i, 0.);
-                // timings_act_.emplace(i, 0.);
-                // auto agent_start_ = high_resolution_clock::now();
-                // auto agent_act_ = high_resolution_clock::now();
+            // runs one agent, and returns the time of its next event
+            auto job_ = [&](agent *a) -> time_point {
                 // The seed is deterministic in the following variables:
                 std::seed_seq seed_ {
                     std::uint64_t(std::hash<identity<agent>>()(a->identifier)),
                     std::uint64_t(step.lower), std::uint64_t(round_),
                     sample};
+                // the same variables key the agent's random stream, which
+                // unlike the seed sequence needs no allocation
+                a->rng = computation::random_stream(
+                    sample, a->identifier.digits.hash(), step.lower, round_);
 
-                // try {
-
-                {
-                    std::unique_lock lock_(mutex_first_event_);
-                    first_event_ = std::min(first_event_,
-                                            a->process_messages(step, seed_));
-                    // agent_cb_end_ = double((high_resolution_clock::now() - agent_start_).count()); agent_act_ = high_resolution_clock::now();
-                    first_event_ = std::min(first_event_, a->act(step, seed_));
+                std::unique_lock lock_(mutex_serialized_, std::defer_lock);
+                if(pool_ && agent::serialized == a->execution) {
+                    lock_.lock();
                 }
 
-                //} catch(const std::runtime_error &e) {
-                //    LOG(errorlog) << e.what() << std::endl;
-                //    throw e;
-                //} catch(const std::exception &e) {
-                //    LOG(errorlog) <<  e.what() << std::endl;
-                //    throw e;
-                //} catch(...) {
-                //    throw;
-                //}
-                a->inbox.clear();
-                // auto agent_end_ = high_resolution_clock::now() - agent_start_;
-
-                // timings_cb_[a->identifier] += agent_cb_end_;
-                // timings_act_[a->identifier] += double( (high_resolution_clock::now() - agent_act_).count());
-                // timings_[a->identifier] += (double(agent_end_.count()) );
-                // LOG(notice) << "a" << a->identifier << " tcb " << step << " " << std::setprecision(8) << timings_cb_[a->identifier]/ 1e+9/step.lower <<  " s" << std::endl; LOG(notice) << "a" << a->identifier << " tac " << step << " " << std::setprecision(8) << timings_act_[a->identifier]/ 1e+9/step.lower <<  " s" << std::endl;
-
+                time_point next_;
+                if(!measured_) {
+                    next_ = a->process_messages(step, seed_);
+                    next_ = std::min(next_, a->act(step, seed_));
+                }else{
+                    auto before_messaging_ = high_resolution_clock::now();
+                    next_ = a->process_messages(step, seed_);
+                    auto before_acting_ = high_resolution_clock::now();
+                    next_ = std::min(next_, a->act(step, seed_));
+                    a->timing.record(before_acting_ - before_messaging_,
+                                     high_resolution_clock::now() - before_acting_);
+                }
+                // messages due later stay, and the agent runs when they are
+                a->inbox.erase_until(step.lower);
+                if(!a->inbox.empty()) {
+                    next_ = std::min(next_, a->inbox.begin()->first);
+                }
+                // each agent is run by one worker, so this needs no lock
+                a->wakeup_.scheduled = next_;
+                return next_;
             };
 
-            // important: if using a single thread, run everything in main
-            if(threads <= 1) {
-                for(auto &[i, a] : agents.local_agents_) {
-                    job_(a);
+            if(by_event == activation) {
+                schedule_.clear();
+                agents.due(step.lower, schedule_);
+            }
+
+            if(!pool_ && by_event != activation) {
+                for(auto *a : agents.slots()) {
+                    if(nullptr != a) {
+                        first_event_ = std::min(first_event_, job_(a));
+                        environment_.agent_finished(*a);
+                    }
+                }
+            }else if(!pool_) {
+                for(auto *a : schedule_) {
+                    first_event_ = std::min(first_event_, job_(a));
+                    environment_.agent_finished(*a);
                 }
             }else{
-                std::vector<std::thread> threads_;
-                auto iterator_ = agents.local_agents_.begin();
-                for(const auto& tasks_: quantity(agents.local_agents_.size()) / threads){
-                    std::vector<std::shared_ptr<agent>> task_split_;
-                    for(auto i = quantity(0); i < tasks_; ++i){
-                        task_split_.push_back(iterator_->second);
-                        std::advance(iterator_, 1);
+                if(by_event != activation) {
+                    schedule_.clear();
+                    for(auto *a : agents.slots()) {
+                        if(nullptr != a) {
+                            schedule_.push_back(a);
+                        }
+                    }
+                }
+
+                // the calling thread serves the environment while it waits
+                auto progress_ = [this]() {
+                    return environment_.progress();
+                };
+
+                if(static_partition == scheduler) {
+                    // contiguous ranges, one per worker, each computing the
+                    // minimum over its own range without synchronisation
+                    size_t chunk_ = (schedule_.size() + threads - 1) / threads;
+                    pool_->fork_join(threads, [&](unsigned int t) {
+                        size_t begin_ = std::min(schedule_.size(), t * chunk_);
+                        size_t end_   = std::min(schedule_.size(), begin_ + chunk_);
+                        time_point local_ = step.upper;
+                        for(size_t j = begin_; j < end_; ++j) {
+                            local_ = std::min(local_, job_(schedule_[j]));
+                            environment_.agent_finished(*schedule_[j]);
+                        }
+                        worker_results_[t].first_event = local_;
+                    }, progress_);
+                }else{
+                    if(cost_balanced == scheduler) {
+                        assign_by_cost();
+                    }else{
+                        ranges_.assign(computation::work_stealing::task_t(schedule_.size()));
                     }
 
-                    threads_.emplace_back([&](std::vector<std::shared_ptr<agent>> ts)
-                        {
-                            for(const auto& a: ts){
-                                job_(a);
-                            }
-                        }, task_split_);
+                    pool_->fork_join(threads, [&](unsigned int t) {
+                        time_point local_ = step.upper;
+                        computation::work_stealing::task_t j;
+                        while(ranges_.next(t, j)) {
+                            local_ = std::min(local_, job_(schedule_[j]));
+                            environment_.agent_finished(*schedule_[j]);
+                        }
+                        worker_results_[t].first_event = local_;
+                    }, progress_);
                 }
 
-                for(auto &t: threads_){
-                    t.join();
+                // fork_join synchronises with all workers, so the results
+                // can be read without locks
+                for(const auto &r : worker_results_) {
+                    first_event_ = std::min(first_event_, r.first_event);
+                }
+            }
+
+            if(by_event == activation) {
+                // agents that did not run keep their previous wake-up event
+                for(auto *a : schedule_) {
+                    agents.schedule(a);
                 }
             }
 
             environment_.send_messages(*this);
+
+            if(by_event == activation) {
+                // includes agents that did not run in this round
+                first_event_ = std::min(first_event_, agents.next_event());
+            }
+            first_event_ = environment_.first_event(first_event_);
             ++round_;
             ++rounds_;
         } while(step.lower >= first_event_);
 
         environment_.after_step(*this);
+#ifdef WITH_PROFILING
+        if(computation::profiler::instance().enabled()) {
+            computation::profiler::instance().aggregate();
+        }
+#endif
         auto total_ = high_resolution_clock::now() - timer_start_;
         //LOG(notice) << "step " << step << " took " << (double(total_.count()) / 1e+9) <<  " seconds" << std::endl;
         return first_event_;
     }
 
+    ///
+    /// \brief  Divides `schedule_` into contiguous ranges of roughly equal
+    ///         estimated cost, in a single pass over the prefix sums.
+    ///
+    /// \details    Agents without measurements yet are given the mean cost of
+    ///             the measured agents, or unit cost if there are none.
+    ///
+    void model::assign_by_cost()
+    {
+        using computation::work_stealing;
+
+        std::chrono::nanoseconds total_(0);
+        size_t measured_ = 0;
+        for(const auto *a : schedule_) {
+            if(a->timing.estimate.count() > 0) {
+                total_ += a->timing.estimate;
+                ++measured_;
+            }
+        }
+
+        auto unmeasured_ = std::chrono::nanoseconds(1);
+        if(0 < measured_) {
+            unmeasured_ = std::max(unmeasured_, total_ / std::int64_t(measured_));
+        }
+        total_ += unmeasured_ * std::int64_t(schedule_.size() - measured_);
+
+        auto cost_ = [&](const agent *a) {
+            return 0 < a->timing.estimate.count() ? a->timing.estimate
+                                                  : unmeasured_;
+        };
+
+        work_stealing::task_t begin_ = 0;
+        std::chrono::nanoseconds prefix_(0);
+        for(unsigned int w = 0; w < threads; ++w) {
+            // the worker's range ends where the prefix sum passes its share
+            auto target_ = total_ * std::int64_t(w + 1) / std::int64_t(threads);
+            auto end_    = begin_;
+            while(end_ < schedule_.size()
+                  && (prefix_ < target_ || w + 1 == threads)) {
+                prefix_ += cost_(schedule_[end_]);
+                ++end_;
+            }
+            ranges_.assign(w, begin_, end_);
+            begin_ = end_;
+        }
+    }
+
     ///
     /// \brief
     ///
@@ -166,4 +311,14 @@ namespace esl::simulation {
 
     }
 
+    void model::save_state(boost::archive::binary_oarchive &archive)
+    {
+        (void)archive;
+    }
+
+    void model::load_state(boost::archive::binary_iarchive &archive)
+    {
+        (void)archive;
+    }
+
 }  // namespace esl::simulation
@@ -26,14 +26,24 @@
 #define ESL_SIMULATION_MODEL_HPP
 
 #include <memory>
+#include <mutex>
 #include <unordered_set>
+#include <vector>
 
+#include <esl/computation/thread_pool.hpp>
+#include <esl/computation/work_stealing.hpp>
 #include <esl/simulation/time.hpp>
 #include <esl/simulation/world.hpp>
 #include <esl/simulation/agent_collection.hpp>
 #include <esl/simulation/parameter/parametrization.hpp>
 
+namespace boost::archive {
+    class binary_iarchive;
+    class binary_oarchive;
+}
+
 namespace esl::computation {
+    class checkpoint;
     class environment;
 }
 
@@ -42,6 +52,12 @@ namespace esl::simulation {
     class model
     {
     protected:
+        // allows the environment to deliver messages using the thread pool
+        friend class computation::environment;
+
+        // saves and restores the number of rounds
+        friend class computation::checkpoint;
+
         computation::environment &environment_;
 
         ///
@@ -49,6 +65,53 @@ namespace esl::simulation {
         ///
         unsigned int rounds_;
 
+        ///
+        /// \brief  Worker threads used to run agents in parallel, created
+        ///         once when `threads > 1` and reused for every round.
+        ///
+        std::unique_ptr<computation::thread_pool> pool_;
+
+        ///
+        /// \brief  Flat view of the local agents for the current round,
+        ///         which is partitioned into contiguous ranges over the
+        ///         workers. Its capacity is kept between rounds.
+        ///
+        std::vector<agent *> schedule_;
+
+        ///
+        /// \brief  The earliest next event found by one worker in the current
+        ///         round. Aligned to separate cache lines, so that workers do
+        ///         not contend while computing their local minimum.
+        ///
+        struct alignas(64) worker_result
+        {
+            time_point first_event;
+        };
+
+        ///
+        /// \brief  One result per worker, reduced by the calling thread after
+        ///         all workers have joined.
+        ///
+        std::vector<worker_result> worker_results_;
+
+        ///
+        /// \brief  Per-worker ranges of `schedule_` used by the work
+        ///         stealing schedulers.
+        ///
+        computation::work_stealing ranges_;
+
+        ///
+        /// \brief  Held while running agents that have
+        ///         `agent::execution == agent::serialized`.
+        ///
+        std::mutex mutex_serialized_;
+
+        ///
+        /// \brief  Sets the work stealing ranges using the agents' measured
+        ///         cost.
+        ///
+        void assign_by_cost();
+
     public:
         ///
         /// \brief
@@ -100,12 +163,72 @@ namespace esl::simulation {
 
         ///
         /// \brief  The number of threads to run the model in parallel.
-        ///         By default, no parallelism is used
+        ///         By default, no parallelism is used. When the `threads`
+        ///         parameter is zero, the environment decides (see
+        ///         `computation::environment::hardware_threads`).
         ///
+        /// \details    Fixed at construction, as it determines the size of
+        ///             the model's thread pool.
         ///
-        /// \details
+        const unsigned int threads;
+
         ///
-        unsigned int threads;
+        /// \brief  Ways of dividing the agents over the threads.
+        ///
+        enum scheduling
+        {
+            ///
+            /// \brief  Every thread runs an equally sized, fixed range of
+            ///         agents.
+            ///
+            static_partition = 0,
+
+            ///
+            /// \brief  Threads start with equally sized ranges, and threads
+            ///         that finish early steal agents from busy threads.
+            ///
+            work_stealing = 1,
+
+            ///
+            /// \brief  As `work_stealing`, but ranges are sized so that they
+            ///         take roughly equal time, using the time each agent
+            ///         took in previous rounds (`agent::timing`). This adds
+            ///         the cost of measuring every agent.
+            ///
+            cost_balanced = 2
+        };
+
+        ///
+        /// \brief  The scheduler used when `threads > 1`, read from the
+        ///         `scheduler` parameter.
+        ///
+        const scheduling scheduler;
+
+        ///
+        /// \brief  Ways of selecting the agents that run in a round.
+        ///
+        enum activation_mode
+        {
+            ///
+            /// \brief  Every agent runs in every round.
+            ///
+            all_agents = 0,
+
+            ///
+            /// \brief  An agent runs only when it received messages since it
+            ///         last ran, when the round reached the next event it
+            ///         returned, or when it has the `agent::every_round`
+            ///         activation policy. Rounds then cost time proportional
+            ///         to the number of active agents instead of all agents.
+            ///
+            by_event = 1
+        };
+
+        ///
+        /// \brief  How agents are selected to run, read from the
+        ///         `activation` parameter.
+        ///
+        const activation_mode activation;
 
         ///
         /// \brief
@@ -173,6 +296,16 @@ namespace esl::simulation {
         ///
         virtual time_point step(time_interval step);
 
+        ///
+        /// \brief  The agents that ran in the current round. Only maintained
+        ///         when `activation == by_event`, in which case only these
+        ///         agents can have sent messages.
+        ///
+        const std::vector<agent *> &scheduled_agents() const
+        {
+            return schedule_;
+        }
+
         ///
         /// \return
         inline time_point step()
@@ -184,6 +317,17 @@ namespace esl::simulation {
         /// \brief  Run statistical analyses for the model.
         ///
         virtual void terminate();
+
+        ///
+        /// \brief  Saves state of the model outside its agents to a
+        ///         checkpoint. The default saves nothing.
+        ///
+        virtual void save_state(boost::archive::binary_oarchive &archive);
+
+        ///
+        /// \brief  Restores the state saved by `save_state`.
+        ///
+        virtual void load_state(boost::archive::binary_iarchive &archive);
     };
 }  // namespace esl::simulation
 
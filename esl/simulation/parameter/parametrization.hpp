@@ -46,6 +46,14 @@ namespace esl::simulation::parameter {
         /// \param sample
         /// \param start
         /// \param end
+        /// \param verbosity
+        /// \param threads
+        /// \param scheduler    How agents are divided over threads, see
+        ///                     \ref esl::simulation::model::scheduling
+        /// \param activation   Which agents run in a round, see
+        ///                     \ref esl::simulation::model::activation_mode
+        /// \param inbox        The inbox storage for all agents, see
+        ///                     \ref esl::interaction::inbox::storage_t
         parametrization( std::uint64_t sample       = 0
                        , time_point start           = time_point()
                        , time_point end             = time_point() + 1
@@ -54,14 +62,20 @@ namespace esl::simulation::parameter {
 #else
                        , std::uint64_t verbosity    = 1
 #endif
-                       , unsigned int threads       = 1)
+                       , unsigned int threads       = 1
+                       , std::uint64_t scheduler    = 0
+                       , std::uint64_t activation   = 0
+                       , std::uint64_t inbox        = 0)
 
         {
             values["sample"]    = std::make_shared<constant<std::uint64_t>>(sample);
             values["start"]     = std::make_shared<constant<time_point>>(start);
             values["end"]       = std::make_shared<constant<time_point>>(end);
             values["verbosity"] = std::make_shared<constant<std::uint64_t>>(verbosity);
-            values["threads"]   = std::make_shared<constant<std::uint64_t>>(verbosity);
+            values["threads"]   = std::make_shared<constant<std::uint64_t>>(threads);
+            values["scheduler"] = std::make_shared<constant<std::uint64_t>>(scheduler);
+            values["activation"] = std::make_shared<constant<std::uint64_t>>(activation);
+            values["inbox"]     = std::make_shared<constant<std::uint64_t>>(inbox);
         }
 
 
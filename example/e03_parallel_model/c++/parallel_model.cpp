@@ -0,0 +1,118 @@
+/// \file   parallel_model.cpp
+///
+/// \brief  Measures how `model::step` scales with the number of threads on a
+///         population of independent agents, for each scheduler. Pass a
+///         skew to make some agents much more expensive than others.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include <esl/agent.hpp>
+#include <esl/computation/environment.hpp>
+#include <esl/simulation/model.hpp>
+
+using namespace esl;
+using namespace esl::simulation;
+
+// an agent that does a fixed amount of arithmetic every time step, and does
+// not interact with any other agent
+struct busy_agent
+: public agent
+{
+    using agent::agent;
+
+    unsigned int work = 10'000;
+
+    double state = 0.;
+
+    time_point act(time_interval step, std::seed_seq &seed) override
+    {
+        (void) seed;
+        for(unsigned int i = 0; i < work; ++i){
+            state = std::sin(state + i);
+        }
+        return step.lower + 1;
+    }
+};
+
+struct busy_model
+: public model
+{
+    using model::model;
+
+    unsigned int population = 10'000;
+
+    // every `skew`-th agent does `skew` times as much work, 0 for uniform
+    unsigned int skew = 0;
+
+    void initialize() override
+    {
+        for(unsigned int i = 0; i < population; ++i){
+            auto a = create<busy_agent>();
+            if(0 < skew && 0 == i % skew){
+                a->work *= skew;
+            }
+        }
+    }
+};
+
+// usage: parallel_model [agents] [steps] [skew]
+int main(int argc, char** argv)
+{
+    unsigned int agents_ = argc > 1 ? std::stoul(argv[1]) : 10'000;
+    time_point steps_ = argc > 2 ? std::stoull(argv[2]) : 10;
+    unsigned int skew_ = argc > 3 ? std::stoul(argv[3]) : 0;
+    unsigned int hardware_ = std::max(1u, std::thread::hardware_concurrency());
+
+    const char *names_[] = {"static", "stealing", "cost"};
+
+    double baseline_ = 0.;
+    std::cout << "scheduler | threads | seconds | speed-up" << std::endl;
+    for(std::uint64_t scheduler_ = model::static_partition; scheduler_ <= model::cost_balanced; ++scheduler_){
+        for(unsigned int threads_ = 1; threads_ <= hardware_; threads_ *= 2){
+            computation::environment environment_;
+            busy_model model_(environment_, parameter::parametrization(0, 0, steps_, 0, threads_, scheduler_));
+            model_.population = agents_;
+            model_.skew = skew_;
+            model_.initialize();
+
+            auto start_ = std::chrono::high_resolution_clock::now();
+            for(time_point t = 0; t < steps_; ++t){
+                model_.step({t, steps_});
+            }
+            std::chrono::duration<double> elapsed_ = std::chrono::high_resolution_clock::now() - start_;
+
+            if(1 == threads_ && model::static_partition == scheduler_){
+                baseline_ = elapsed_.count();
+            }
+            std::cout << std::setw(9) << names_[scheduler_] << " | "
+                      << std::setw(7) << threads_ << " | "
+                      << std::setw(7) << std::setprecision(3) << elapsed_.count() << " | "
+                      << std::setprecision(3) << baseline_ / elapsed_.count()
+                      << std::endl;
+        }
+    }
+}
@@ -0,0 +1,133 @@
+/// \file   inbox.cpp
+///
+/// \brief  Compares the ordered and the bucketed inbox storage, on the inbox
+///         alone and in a model where agents message each other every step.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include <esl/agent.hpp>
+#include <esl/computation/environment.hpp>
+#include <esl/interaction/inbox.hpp>
+#include <esl/simulation/model.hpp>
+
+using namespace esl;
+using namespace esl::simulation;
+
+// sends `fan_out` messages every time step, due now or in the next step
+struct messaging_agent
+: public agent
+{
+    using agent::agent;
+
+    std::vector<identity<agent>> targets;
+
+    time_point act(time_interval step, std::seed_seq &seed) override
+    {
+        (void) seed;
+        for(size_t k = 0; k < targets.size(); ++k){
+            send_message(std::make_shared<interaction::header>(
+                0, identifier, targets[k], step.lower, step.lower + k % 2));
+        }
+        return step.lower + 1;
+    }
+};
+
+struct messaging_model
+: public model
+{
+    using model::model;
+
+    unsigned int population = 10'000;
+
+    unsigned int fan_out = 10;
+
+    void initialize() override
+    {
+        std::vector<std::shared_ptr<messaging_agent>> agents_;
+        for(unsigned int i = 0; i < population; ++i){
+            agents_.push_back(create<messaging_agent>());
+        }
+        for(size_t i = 0; i < agents_.size(); ++i){
+            for(size_t k = 0; k < fan_out; ++k){
+                auto j = (i * 7919 + k * 104729) % agents_.size();
+                agents_[i]->targets.push_back(agents_[j]->identifier);
+            }
+        }
+    }
+};
+
+// fills the inbox with messages due in the current and next time step, and
+// drains it, as an agent does every round
+double fill_and_drain(interaction::inbox::storage_t storage, size_t messages, size_t rounds)
+{
+    interaction::inbox inbox_(storage);
+    auto message_ = std::make_shared<interaction::header>();
+    size_t checksum_ = 0;
+
+    auto start_ = std::chrono::high_resolution_clock::now();
+    for(size_t r = 0; r < rounds; ++r){
+        for(size_t m = 0; m < messages; ++m){
+            inbox_.insert({time_point(r + m % 2), message_});
+        }
+        for(const auto &[k, v] : inbox_){
+            checksum_ += k;
+        }
+        inbox_.clear();
+    }
+    std::chrono::duration<double> elapsed_ = std::chrono::high_resolution_clock::now() - start_;
+    return checksum_ ? elapsed_.count() : 0.;
+}
+
+// usage: inbox [agents] [steps] [fan_out]
+int main(int argc, char** argv)
+{
+    unsigned int agents_ = argc > 1 ? std::stoul(argv[1]) : 10'000;
+    time_point steps_ = argc > 2 ? std::stoull(argv[2]) : 10;
+    unsigned int fan_out_ = argc > 3 ? std::stoul(argv[3]) : 10;
+
+    const char *names_[] = {"ordered", "bucketed"};
+
+    std::cout << "storage  | inbox only (s) | model (s)" << std::endl;
+    for(auto storage_ : {interaction::inbox::ordered, interaction::inbox::bucketed}){
+        auto inbox_only_ = fill_and_drain(storage_, fan_out_, agents_ * steps_);
+
+        computation::environment environment_;
+        messaging_model model_(environment_, parameter::parametrization(0, 0, steps_, 0, 1, 0, 0, storage_));
+        model_.population = agents_;
+        model_.fan_out = fan_out_;
+        model_.initialize();
+
+        auto start_ = std::chrono::high_resolution_clock::now();
+        for(time_point t = 0; t < steps_; ++t){
+            model_.step({t, steps_});
+        }
+        std::chrono::duration<double> elapsed_ = std::chrono::high_resolution_clock::now() - start_;
+
+        std::cout << std::setw(8) << names_[storage_] << " | "
+                  << std::setw(14) << std::setprecision(3) << inbox_only_ << " | "
+                  << std::setw(9) << std::setprecision(3) << elapsed_.count()
+                  << std::endl;
+    }
+}
@@ -0,0 +1,78 @@
+/// \file   shared_mpi_ring.hpp
+///
+/// \brief  Agents on a ring of MPI processes, for testing
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_SHARED_MPI_RING_HPP
+#define ESL_SHARED_MPI_RING_HPP
+
+#ifdef WITH_MPI
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/simulation/model.hpp>
+
+#include <memory>
+#include <vector>
+
+///
+/// \brief  Creates `agents` agents on every process, with identities that
+///         are unique over all processes, and finds the agents created on
+///         the next process.
+///
+/// \details    Every process skips the identities created by lower ranks.
+///             This is a collective operation.
+///
+/// \param m        The model on this process
+/// \param c        The processes in the ring
+/// \param agents   The number of agents on every process
+/// \param next     Receives the identities of the agents on the next
+///                 process, in the order they were created
+/// \return The agents created on this process
+template<typename agent_derived_t_>
+std::vector<std::shared_ptr<agent_derived_t_>>
+create_ring(esl::simulation::model &m, const boost::mpi::communicator &c,
+            unsigned int agents,
+            std::vector<esl::identity<esl::agent>> &next)
+{
+    for(int r = 0; r < c.rank() * int(agents); ++r) {
+        m.create_identifier<agent_derived_t_>();
+    }
+    std::vector<std::shared_ptr<agent_derived_t_>> result_;
+    std::vector<esl::identity<esl::agent>> created_;
+    for(unsigned int i = 0; i < agents; ++i) {
+        result_.push_back(m.create<agent_derived_t_>());
+        created_.push_back(result_.back()->identifier);
+    }
+
+    std::vector<std::vector<esl::identity<esl::agent>>> identities_;
+    boost::mpi::all_gather(c, created_, identities_);
+    next = identities_[(c.rank() + 1) % c.size()];
+    return result_;
+}
+
+#endif  // WITH_MPI
+
+#endif  // ESL_SHARED_MPI_RING_HPP
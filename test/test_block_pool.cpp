@@ -31,6 +31,9 @@
 
 #include <boost/test/included/unit_test.hpp>
 
+#include <thread>
+#include <vector>
+
 #include <esl/computation/block_pool.hpp>
 
 
@@ -61,4 +64,81 @@ BOOST_AUTO_TEST_SUITE(ESL)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(block_pool_stale_index)
+    {
+        esl::computation::block_pool::static_block_pool<int> bp_(4);
+
+        auto a = bp_.emplace(1);
+        BOOST_CHECK_EQUAL(bp_.at(a.first), 1);
+        bp_.erase(a.first);
+        BOOST_CHECK(nullptr == bp_.find(a.first));
+        BOOST_CHECK_THROW(bp_.at(a.first), std::out_of_range);
+
+        // the block is reused with a new index
+        auto b = bp_.emplace(2);
+        BOOST_CHECK(a.second == b.second);
+        BOOST_CHECK_NE(a.first, b.first);
+        BOOST_CHECK(nullptr == bp_.find(a.first));
+        BOOST_CHECK(b.second == bp_.find(b.first));
+
+        // indices of positions that were never allocated
+        BOOST_CHECK(nullptr == bp_.find(1000));
+    }
+
+    ///
+    /// \brief  Growing adds chunks, and existing elements stay in place
+    ///
+    BOOST_AUTO_TEST_CASE(block_pool_grow)
+    {
+        esl::computation::block_pool::static_block_pool<std::uint64_t> bp_(3, true);
+
+        std::vector<std::pair<std::uint64_t, esl::computation::block_pool::block<std::uint64_t> *>> placed_;
+        for(std::uint64_t i = 0; i < 100; ++i) {
+            placed_.emplace_back(bp_.emplace(i));
+        }
+        BOOST_CHECK_EQUAL(bp_.size(), 100);
+        BOOST_CHECK_GE(bp_.capacity(), 100);
+
+        for(std::uint64_t i = 0; i < 100; ++i) {
+            BOOST_CHECK(placed_[i].second == bp_.find(placed_[i].first));
+            BOOST_CHECK_EQUAL(bp_[placed_[i].first], i);
+        }
+    }
+
+    ///
+    /// \brief  Threads sharing a pool place and erase elements through
+    ///         their own free lists
+    ///
+    BOOST_AUTO_TEST_CASE(block_pool_local_free_list)
+    {
+        typedef esl::computation::block_pool::static_block_pool<std::uint64_t> pool_t;
+        pool_t bp_(16, true);
+
+        std::vector<std::thread> threads_;
+        std::vector<char> correct_(4, true);
+        for(std::uint64_t t = 0; t < 4; ++t) {
+            threads_.emplace_back([&, t]() {
+                pool_t::local_free_list local_(bp_, 8);
+                std::vector<std::uint64_t> indices_;
+                for(std::uint64_t round_ = 0; round_ < 50; ++round_) {
+                    for(std::uint64_t i = 0; i < 20; ++i) {
+                        indices_.push_back(local_.emplace(t * 1000 + i).first);
+                    }
+                    for(std::uint64_t i = 0; i < 20; ++i) {
+                        correct_[t] = correct_[t] && (t * 1000 + i == bp_[indices_[i]]);
+                        local_.erase(indices_[i]);
+                    }
+                    indices_.clear();
+                }
+            });
+        }
+        for(auto &t: threads_) {
+            t.join();
+        }
+        for(char c: correct_) {
+            BOOST_CHECK(c);
+        }
+        BOOST_CHECK_EQUAL(bp_.size(), 0);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()  // ESL
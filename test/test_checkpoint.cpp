@@ -0,0 +1,361 @@
+/// \file   test_checkpoint.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE checkpoint
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <filesystem>
+#include <sstream>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/export.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/computation/checkpoint.hpp>
+#include <esl/computation/environment.hpp>
+#include <esl/interaction/message.hpp>
+#include <esl/simulation/model.hpp>
+
+
+using namespace esl;
+using namespace esl::simulation;
+
+
+struct ping_message
+: public interaction::message<ping_message, (std::uint64_t(0x1) << 62u) | 25>
+{
+    std::uint32_t number = 0;
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("message",
+            boost::serialization::base_object<interaction::message<
+                ping_message, (std::uint64_t(0x1) << 62u) | 25>>(*this));
+        archive &BOOST_SERIALIZATION_NVP(number);
+    }
+};
+
+// messages in inboxes are saved with their recipient
+BOOST_CLASS_EXPORT(ping_message)
+
+///
+/// \brief  Runs every other time point, draws a random number, and sends it
+///         to its partner, who receives it three time points later.
+///
+struct ping_agent
+: public agent
+{
+    identity<agent> partner;
+
+    unsigned int acted = 0;
+
+    std::vector<std::uint32_t> received;
+
+    std::shared_ptr<data::output<std::uint32_t>> drawn;
+
+    ping_agent()
+    {
+        setup();
+    }
+
+    explicit ping_agent(const identity<ping_agent> &i)
+    : agent(i)
+    {
+        setup();
+    }
+
+    void setup()
+    {
+        drawn = create_output<std::uint32_t>("drawn");
+        std::function<time_point(std::shared_ptr<ping_message>, time_interval,
+                                 std::seed_seq &)> receive_ =
+            [this](std::shared_ptr<ping_message> m, time_interval step,
+                   std::seed_seq &seed) {
+                (void)seed;
+                received.push_back(m->number);
+                return step.upper;
+            };
+        register_callback<ping_message>(receive_);
+    }
+
+    time_point act(time_interval step, std::seed_seq &seed) override
+    {
+        (void)seed;
+        ++acted;
+        auto number_ = std::uint32_t(rng());
+        drawn->put(step.lower, number_);
+        auto m = create_message<ping_message>(partner, step.lower + 3);
+        m->sender = identifier;
+        m->sent   = step.lower;
+        m->number = number_;
+        return step.lower + 2;
+    }
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("agent",
+            boost::serialization::base_object<agent>(*this));
+        archive &BOOST_SERIALIZATION_NVP(partner);
+        archive &BOOST_SERIALIZATION_NVP(acted);
+        archive &BOOST_SERIALIZATION_NVP(received);
+    }
+};
+
+BOOST_CLASS_EXPORT(ping_agent)
+
+///
+/// \brief  Four agents in a ring, and a counter saved with the model.
+///
+struct ping_model
+: public model
+{
+    using model::model;
+
+    unsigned int steps = 0;
+
+    ///
+    /// \brief  Steps taken since the model was constructed, not saved
+    ///
+    unsigned int steps_run = 0;
+
+    void initialize() override
+    {
+        std::vector<std::shared_ptr<ping_agent>> ring_;
+        for(unsigned int i = 0; i < 4; ++i) {
+            ring_.push_back(create<ping_agent>());
+        }
+        for(unsigned int i = 0; i < ring_.size(); ++i) {
+            ring_[i]->partner = ring_[(i + 1) % ring_.size()]->identifier;
+        }
+    }
+
+    time_point step(time_interval step) override
+    {
+        ++steps;
+        ++steps_run;
+        return model::step(step);
+    }
+
+    void save_state(boost::archive::binary_oarchive &archive) override
+    {
+        archive << steps;
+    }
+
+    void load_state(boost::archive::binary_iarchive &archive) override
+    {
+        archive >> steps;
+    }
+};
+
+///
+/// \brief  The state of every agent, by identity
+///
+std::map<identity<agent>, std::tuple<unsigned int, std::vector<std::uint32_t>,
+                                     std::vector<std::uint32_t>>>
+    state(ping_model &m)
+{
+    std::map<identity<agent>, std::tuple<unsigned int,
+                                         std::vector<std::uint32_t>,
+                                         std::vector<std::uint32_t>>> result_;
+    for(auto *a : m.agents.slots()) {
+        auto *p = dynamic_cast<ping_agent *>(a);
+        std::vector<std::uint32_t> drawn_;
+        for(const auto &v : p->drawn->values) {
+            drawn_.push_back(std::get<1>(v));
+        }
+        auto received_ = p->received;
+        std::sort(received_.begin(), received_.end());
+        result_[p->identifier] = {p->acted, received_, drawn_};
+    }
+    return result_;
+}
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    ///
+    /// \brief  A run that is stopped and resumed from its latest snapshot
+    ///         ends in the same state as a run that was not interrupted.
+    ///
+    BOOST_AUTO_TEST_CASE(checkpoint_resume)
+    {
+        auto path_ = (std::filesystem::temp_directory_path()
+                     / "esl_test_checkpoint").string();
+        for(const auto *suffix_ : {"", ".previous", ".partial"}) {
+            std::filesystem::remove(path_ + suffix_);
+        }
+
+        auto parameters_ = parameter::parametrization(0, 0, 20, 0, 1
+                                                     , model::static_partition
+                                                     , model::by_event);
+
+        computation::environment uninterrupted_;
+        ping_model expected_(uninterrupted_, parameters_);
+        uninterrupted_.run(expected_);
+
+        // a snapshot at least every 4 time points, of which the last two
+        // are kept
+        computation::environment first_;
+        first_.checkpoints.path     = path_;
+        first_.checkpoints.interval = 4;
+        ping_model stopped_(first_, parameters_);
+        first_.run(stopped_);
+        BOOST_CHECK(state(expected_) == state(stopped_));
+        auto latest_   = computation::checkpoint::peek(path_);
+        auto previous_ = computation::checkpoint::peek(path_ + ".previous");
+        BOOST_REQUIRE(latest_ && previous_);
+        BOOST_CHECK_LE(*latest_ - *previous_, 4);
+        BOOST_CHECK_LT(20 - *latest_, 4);
+
+        computation::environment second_;
+        second_.checkpoints.path = path_;
+        ping_model resumed_(second_, parameters_);
+        second_.run(resumed_);
+        BOOST_CHECK(state(expected_) == state(resumed_));
+        BOOST_CHECK_EQUAL(resumed_.steps, expected_.steps);
+        BOOST_CHECK_LT(resumed_.steps_run, expected_.steps);
+
+        for(const auto *suffix_ : {"", ".previous"}) {
+            std::filesystem::remove(path_ + suffix_);
+        }
+    }
+
+    ///
+    /// \brief  A run stopped after the latest snapshot was moved aside, but
+    ///         before the new one was put in place, resumes from the
+    ///         previous snapshot.
+    ///
+    BOOST_AUTO_TEST_CASE(checkpoint_resume_previous)
+    {
+        auto path_ = (std::filesystem::temp_directory_path()
+                     / "esl_test_checkpoint_previous").string();
+        for(const auto *suffix_ : {"", ".previous", ".partial"}) {
+            std::filesystem::remove(path_ + suffix_);
+        }
+
+        auto parameters_ = parameter::parametrization(0, 0, 20, 0, 1
+                                                     , model::static_partition
+                                                     , model::by_event);
+
+        computation::environment uninterrupted_;
+        ping_model expected_(uninterrupted_, parameters_);
+        uninterrupted_.run(expected_);
+
+        computation::environment first_;
+        first_.checkpoints.path     = path_;
+        first_.checkpoints.interval = 4;
+        ping_model stopped_(first_, parameters_);
+        first_.run(stopped_);
+        std::filesystem::remove(path_);
+        auto previous_ = computation::checkpoint::peek(path_ + ".previous");
+        BOOST_REQUIRE(previous_);
+
+        computation::environment second_;
+        second_.checkpoints.path = path_;
+        ping_model resumed_(second_, parameters_);
+        second_.run(resumed_);
+        BOOST_CHECK(state(expected_) == state(resumed_));
+        BOOST_CHECK_EQUAL(resumed_.steps, expected_.steps);
+        BOOST_CHECK_LT(resumed_.steps_run, expected_.steps);
+
+        for(const auto *suffix_ : {"", ".previous"}) {
+            std::filesystem::remove(path_ + suffix_);
+        }
+    }
+
+    ///
+    /// \brief  Restored agents use the model's inbox storage.
+    ///
+    BOOST_AUTO_TEST_CASE(checkpoint_resume_inbox_storage)
+    {
+        auto path_ = (std::filesystem::temp_directory_path()
+                     / "esl_test_checkpoint_inbox").string();
+        for(const auto *suffix_ : {"", ".previous", ".partial"}) {
+            std::filesystem::remove(path_ + suffix_);
+        }
+
+        auto parameters_ = parameter::parametrization(0, 0, 20, 0, 1
+                                                     , model::static_partition
+                                                     , model::by_event
+                                                     , interaction::inbox::bucketed);
+
+        computation::environment first_;
+        first_.checkpoints.path     = path_;
+        first_.checkpoints.interval = 4;
+        ping_model stopped_(first_, parameters_);
+        first_.run(stopped_);
+
+        computation::environment second_;
+        second_.checkpoints.path = path_;
+        ping_model resumed_(second_, parameters_);
+        second_.run(resumed_);
+        BOOST_CHECK(state(stopped_) == state(resumed_));
+        BOOST_CHECK_LT(resumed_.steps_run, stopped_.steps);
+        for(auto *a : resumed_.agents.slots()) {
+            BOOST_CHECK_EQUAL(a->inbox.storage(), interaction::inbox::bucketed);
+        }
+
+        for(const auto *suffix_ : {"", ".previous"}) {
+            std::filesystem::remove(path_ + suffix_);
+        }
+    }
+
+    ///
+    /// \brief  Agents keep how they are run when they are saved and loaded.
+    ///
+    BOOST_AUTO_TEST_CASE(checkpoint_agent_policies)
+    {
+        ping_agent saved_;
+        saved_.activation = agent::every_round;
+        saved_.execution  = agent::serialized;
+
+        std::stringstream stream_;
+        {
+            boost::archive::binary_oarchive archive_(stream_);
+            archive_ << saved_;
+        }
+        ping_agent loaded_;
+        BOOST_REQUIRE_EQUAL(loaded_.activation, agent::on_event);
+        BOOST_REQUIRE_EQUAL(loaded_.execution, agent::concurrent);
+        {
+            boost::archive::binary_iarchive archive_(stream_);
+            archive_ >> loaded_;
+        }
+        BOOST_CHECK_EQUAL(loaded_.activation, agent::every_round);
+        BOOST_CHECK_EQUAL(loaded_.execution, agent::serialized);
+    }
+
+    BOOST_AUTO_TEST_CASE(checkpoint_missing)
+    {
+        BOOST_CHECK(!computation::checkpoint::peek("esl_no_such_checkpoint"));
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
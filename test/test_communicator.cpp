@@ -39,6 +39,7 @@
 #undef private
 #undef protected
 
+#include <esl/agent.hpp>
 #include <esl/interaction/message.hpp>
 
 #include <functional>
@@ -57,6 +58,18 @@ struct dummy_message_2
 
 };
 
+struct payload_message
+: public esl::interaction::message<payload_message, (std::uint64_t(0x1) << 62u) | 2>
+{
+    std::shared_ptr<const std::vector<int>> payload;
+
+    explicit payload_message(std::shared_ptr<const std::vector<int>> payload = {})
+    : payload(std::move(payload))
+    {
+
+    }
+};
+
 ///
 /// \brief  This testing class defines some callbacks and tracks the order in
 ///         which they are called
@@ -137,6 +150,23 @@ BOOST_AUTO_TEST_CASE(communicator_constructor)
     BOOST_CHECK_EQUAL(ic.callbacks_.find((std::uint64_t(0x1) << 62u) | 1)->second.size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(communicator_dispatch_table)
+{
+    initializes_callbacks ic;
+
+    BOOST_CHECK_EQUAL(ic.dispatch_.size(), 2);
+    BOOST_CHECK(ic.dispatch_[0].type < ic.dispatch_[1].type);
+
+    auto *entry_ = ic.find_dispatch(dummy_message::code);
+    BOOST_REQUIRE(nullptr != entry_);
+    BOOST_CHECK_EQUAL(entry_->priority, 10);
+    BOOST_CHECK_EQUAL(entry_->callbacks.size(), 2);
+    BOOST_CHECK_EQUAL(entry_->callbacks[0].first, 10);
+    BOOST_CHECK_EQUAL(entry_->callbacks[1].first, 0);
+
+    BOOST_CHECK(nullptr == ic.find_dispatch(dummy_message::code + 2));
+}
+
 BOOST_AUTO_TEST_CASE(communicator_process_single_message)
 {
     initializes_callbacks ic;
@@ -154,6 +184,60 @@ BOOST_AUTO_TEST_CASE(communicator_process_single_message)
 }
 
 
+BOOST_AUTO_TEST_CASE(communicator_message_arena)
+{
+    initializes_callbacks ic;
+    esl::identity<esl::agent> recipient_({1});
+
+    auto round_ = [&]() {
+        for(size_t i = 0; i < 1000; ++i) {
+            auto m = ic.create_message<dummy_message>(recipient_, i);
+            BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(m.get())
+                              % esl::interaction::message_arena::granularity, 0);
+        }
+        BOOST_CHECK_EQUAL(ic.outbox.size(), 1000);
+        BOOST_CHECK_EQUAL(ic.outbox.back()->received, 999);
+        ic.outbox.clear();
+    };
+
+    round_();
+    auto chunks_ = esl::interaction::message_arena::statistics().chunks;
+    BOOST_CHECK_LT(0, chunks_);
+
+    // once warmed up, messages reuse the memory of destroyed messages
+    for(size_t r = 0; r < 100; ++r) {
+        round_();
+    }
+    BOOST_CHECK_EQUAL(esl::interaction::message_arena::statistics().chunks,
+                      chunks_);
+}
+
+
+BOOST_AUTO_TEST_CASE(communicator_multicast)
+{
+    initializes_callbacks ic;
+    std::vector<esl::identity<esl::agent>> recipients_ =
+        { esl::identity<esl::agent>({1})
+        , esl::identity<esl::agent>({2})
+        , esl::identity<esl::agent>({3})
+        };
+    auto payload_ = std::make_shared<const std::vector<int>>(1000, 7);
+
+    ic.create_multicast<payload_message>(recipients_, 5, payload_);
+
+    BOOST_CHECK_EQUAL(ic.outbox.size(), recipients_.size());
+    for(size_t i = 0; i < recipients_.size(); ++i) {
+        auto m = std::dynamic_pointer_cast<payload_message>(ic.outbox[i]);
+        BOOST_REQUIRE(m);
+        BOOST_CHECK_EQUAL(m->recipient, recipients_[i]);
+        BOOST_CHECK_EQUAL(m->received, 5);
+        // the payload is shared, not copied
+        BOOST_CHECK_EQUAL(m->payload.get(), payload_.get());
+    }
+    BOOST_CHECK_EQUAL(payload_.use_count(), 1 + recipients_.size());
+}
+
+
 BOOST_AUTO_TEST_CASE(communicator_process_queue)
 {
     initializes_callbacks ic;
@@ -179,4 +263,78 @@ BOOST_AUTO_TEST_CASE(communicator_process_queue)
     BOOST_CHECK(result_);
 }
 
+BOOST_AUTO_TEST_CASE(communicator_process_queue_bucketed)
+{
+    initializes_callbacks ic;
+    ic.inbox.use(esl::interaction::inbox::bucketed);
+    esl::simulation::time_interval step_ = {2, 999};
+
+    for(size_t i = 0; i < 3; ++i) {
+        auto dm = std::make_shared<dummy_message>();
+        ic.inbox.insert({esl::simulation::time_point(i), dm});
+        auto dm2 = std::make_shared<dummy_message_2>();
+        ic.inbox.insert({esl::simulation::time_point(i), dm2});
+    }
+
+    std::seed_seq sequence_ {1};
+
+    ic.process_messages(step_, sequence_);
+
+    std::vector<int> expected_ = {789, 456, 789, 456, 789, 456, 234, 234, 234};
+
+    auto result_ =
+        std::equal(ic.execution_sequence.begin(), ic.execution_sequence.end(),
+                   expected_.begin(), expected_.end());
+
+    BOOST_CHECK(result_);
+}
+
+///
+/// \brief  Both storages must iterate in time order, and in insertion order
+///         for equal times.
+///
+BOOST_AUTO_TEST_CASE(inbox_storage_order)
+{
+    using esl::interaction::inbox;
+    inbox ordered_(inbox::ordered);
+    inbox bucketed_(inbox::bucketed);
+
+    std::vector<std::shared_ptr<esl::interaction::header>> messages_;
+    for(size_t i = 0; i < 100; ++i) {
+        messages_.push_back(std::make_shared<esl::interaction::header>());
+        esl::simulation::time_point t = (i * 37) % 7;
+        ordered_.insert({t, messages_.back()});
+        bucketed_.insert({t, messages_.back()});
+    }
+
+    auto equal_ = [](const inbox &a, const inbox &b) {
+        return a.size() == b.size()
+            && std::equal(a.begin(), a.end(), b.begin(), b.end());
+    };
+
+    BOOST_CHECK_EQUAL(bucketed_.size(), 100);
+    BOOST_CHECK(equal_(ordered_, bucketed_));
+
+    BOOST_CHECK(bucketed_.find(3) != bucketed_.end());
+    BOOST_CHECK(bucketed_.find(3)->second == ordered_.find(3)->second);
+    BOOST_CHECK(bucketed_.find(7) == bucketed_.end());
+
+    BOOST_CHECK_EQUAL(bucketed_.erase(3), ordered_.erase(3));
+    BOOST_CHECK_EQUAL(bucketed_.erase(3), 0);
+    BOOST_CHECK(equal_(ordered_, bucketed_));
+
+    // changing storage keeps the messages and their order
+    inbox converted_(ordered_);
+    converted_.use(inbox::bucketed);
+    BOOST_CHECK(equal_(ordered_, converted_));
+
+    bucketed_.clear();
+    BOOST_CHECK(bucketed_.empty());
+    BOOST_CHECK(bucketed_.begin() == bucketed_.end());
+    bucketed_.insert({5, messages_[0]});
+    bucketed_.insert({1, messages_[1]});
+    BOOST_CHECK_EQUAL(bucketed_.begin()->first, 1);
+    BOOST_CHECK_EQUAL(bucketed_.size(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // ESL
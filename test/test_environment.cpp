@@ -53,6 +53,99 @@ struct test_agent
 };
 
 
+///
+/// \brief  Counts its rounds, and sends one message to `target` in its first
+///         round.
+///
+struct counting_agent
+: public agent
+{
+    using agent::agent;
+
+    unsigned int delay = 0;
+
+    unsigned int acted = 0;
+
+    identity<agent> target;
+
+    ///
+    /// \brief  The time between sending and receiving the message
+    ///
+    time_duration lag = 0;
+
+    time_point act(time_interval step, std::seed_seq &seed) override
+    {
+        (void) seed;
+        if(0 == acted++ && !target.digits.empty()) {
+            send_message(std::make_shared<interaction::header>(
+                0, identifier, target, step.lower, step.lower + lag));
+        }
+        return step.lower + delay;
+    }
+};
+
+///
+/// \brief  Sends one message to each of `targets` every round.
+///
+struct broadcasting_agent
+: public agent
+{
+    using agent::agent;
+
+    std::vector<identity<agent>> targets;
+
+    time_point act(time_interval step, std::seed_seq &seed) override
+    {
+        (void) seed;
+        for(size_t k = 0; k < targets.size(); ++k) {
+            send_message(std::make_shared<interaction::header>(
+                0, identifier, targets[k], k, step.lower));
+        }
+        return step.lower + 1;
+    }
+};
+
+///
+/// \brief  Sends one message to `sink` in every round in which it received
+///         messages.
+///
+struct relaying_agent
+: public agent
+{
+    using agent::agent;
+
+    identity<agent> sink;
+
+    time_point act(time_interval step, std::seed_seq &seed) override
+    {
+        (void) seed;
+        if(!inbox.empty()) {
+            send_message(std::make_shared<interaction::header>(
+                0, identifier, sink, step.lower, step.lower));
+        }
+        return step.lower + 1000;
+    }
+};
+
+///
+/// \brief  Records the random numbers it draws.
+///
+struct drawing_agent
+: public agent
+{
+    using agent::agent;
+
+    std::vector<std::uint32_t> drawn;
+
+    time_point act(time_interval step, std::seed_seq &seed) override
+    {
+        (void) seed;
+        drawn.push_back(rng());
+        drawn.push_back(rng());
+        return step.lower + 1;
+    }
+};
+
 struct test_model
     : public model
 {
@@ -145,4 +238,306 @@ BOOST_AUTO_TEST_SUITE(ESL)
         BOOST_CHECK_EQUAL(next_, 8);
     }
 
+    ///
+    /// \brief  The work stealing schedulers must visit every agent once,
+    ///         and find the same next event as the static partition.
+    ///
+    BOOST_AUTO_TEST_CASE(environment_run_agents_work_stealing)
+    {
+        for(std::uint64_t scheduler_ : {model::work_stealing, model::cost_balanced}) {
+            computation::environment e;
+            test_model tm(e, parameter::parametrization(0, 0, 100, 0, 4, scheduler_));
+            BOOST_CHECK_EQUAL(tm.scheduler, scheduler_);
+
+            auto test_agents = 10'000;
+            for(auto i = 0; i < test_agents; ++i){
+                auto a1 = tm.create<test_agent>();
+                a1->delay = 4 + test_agents - i;
+            }
+
+            auto next_ = tm.step( {0, 3});
+            BOOST_CHECK_EQUAL(next_, 3);
+
+            next_ = tm.step( {3, 1234});
+            BOOST_CHECK_EQUAL(next_, 8);
+
+            next_ = tm.step( {8, 1234});
+            BOOST_CHECK_EQUAL(next_, 13);
+        }
+    }
+
+    ///
+    /// \brief  With event activation, agents run when they are created, when
+    ///         they receive messages and when their next event is due.
+    ///
+    BOOST_AUTO_TEST_CASE(environment_event_activation)
+    {
+        for(unsigned int threads : {1u, 4u}) {
+            computation::environment e;
+            test_model tm(e, parameter::parametrization(0, 0, 100, 0, threads
+                                                       , model::static_partition
+                                                       , model::by_event));
+            BOOST_CHECK_EQUAL(tm.activation, model::by_event);
+
+            auto receiver_ = tm.create<counting_agent>();
+            receiver_->delay = 50;
+            auto sender_ = tm.create<counting_agent>();
+            sender_->delay = 50;
+            sender_->target = receiver_->identifier;
+            auto ticker_ = tm.create<counting_agent>();
+            ticker_->delay = 2;
+
+            // all new agents run, and the message wakes the receiver
+            auto next_ = tm.step({0, 100});
+            BOOST_CHECK_EQUAL(next_, 2);
+            BOOST_CHECK_EQUAL(receiver_->acted, 1);
+            BOOST_CHECK_EQUAL(sender_->acted, 1);
+            BOOST_CHECK_EQUAL(ticker_->acted, 1);
+
+            next_ = tm.step({1, 100});
+            BOOST_CHECK_EQUAL(next_, 2);
+            BOOST_CHECK_EQUAL(receiver_->acted, 2);
+            BOOST_CHECK_EQUAL(sender_->acted, 1);
+            BOOST_CHECK_EQUAL(ticker_->acted, 1);
+
+            next_ = tm.step({2, 100});
+            BOOST_CHECK_EQUAL(next_, 4);
+            BOOST_CHECK_EQUAL(tm.scheduled_agents().size(), 1);
+            BOOST_CHECK_EQUAL(ticker_->acted, 2);
+
+            // nothing is due, no agent runs
+            next_ = tm.step({3, 100});
+            BOOST_CHECK_EQUAL(next_, 4);
+            BOOST_CHECK(tm.scheduled_agents().empty());
+
+            // the receiver asked to run at 51 in step 1
+            next_ = tm.step({51, 100});
+            BOOST_CHECK_EQUAL(receiver_->acted, 3);
+            BOOST_CHECK_EQUAL(sender_->acted, 2);
+            BOOST_CHECK_EQUAL(ticker_->acted, 3);
+            BOOST_CHECK_EQUAL(next_, 53);
+        }
+    }
+
+    ///
+    /// \brief  Messages that are received in the future stay in the inbox,
+    ///         and the recipient runs again when they are due.
+    ///
+    BOOST_AUTO_TEST_CASE(environment_delayed_messages)
+    {
+        for(unsigned int threads : {1u, 2u}) {
+            computation::environment e;
+            test_model tm(e, parameter::parametrization(0, 0, 100, 0, threads
+                                                       , model::static_partition
+                                                       , model::by_event));
+            auto receiver_ = tm.create<counting_agent>();
+            receiver_->delay = 50;
+            auto sender_ = tm.create<counting_agent>();
+            sender_->delay = 50;
+            sender_->lag = 5;
+            sender_->target = receiver_->identifier;
+
+            auto next_ = tm.step({0, 100});
+            BOOST_CHECK_EQUAL(receiver_->inbox.size(), 1);
+
+            // woken by the message, which is not due yet
+            next_ = tm.step({1, 100});
+            BOOST_CHECK_EQUAL(receiver_->acted, 2);
+            BOOST_CHECK_EQUAL(receiver_->inbox.size(), 1);
+            BOOST_CHECK_EQUAL(next_, 5);
+
+            next_ = tm.step({next_, 100});
+            BOOST_CHECK_EQUAL(receiver_->acted, 3);
+            BOOST_CHECK(receiver_->inbox.empty());
+            BOOST_CHECK_EQUAL(next_, 50);
+        }
+    }
+
+    ///
+    /// \brief  Agents that hold a delayed message are still woken by every
+    ///         new message, for any number of threads.
+    ///
+    BOOST_AUTO_TEST_CASE(environment_delayed_messages_wake)
+    {
+        for(unsigned int threads : {1u, 2u}) {
+            computation::environment e;
+            test_model tm(e, parameter::parametrization(0, 0, 100, 0, threads
+                                                       , model::static_partition
+                                                       , model::by_event));
+            auto receiver_ = tm.create<counting_agent>();
+            receiver_->delay = 100;
+            auto holder_ = tm.create<counting_agent>();
+            holder_->delay = 100;
+            holder_->lag = 90;
+            holder_->target = receiver_->identifier;
+            auto ticker_ = tm.create<broadcasting_agent>();
+            ticker_->targets.push_back(receiver_->identifier);
+
+            for(time_point t = 0; t < 4;) {
+                t = tm.step({t, 100});
+            }
+            // runs as a new agent, then once for every round of the ticker
+            BOOST_CHECK_EQUAL(receiver_->acted, 4);
+            BOOST_CHECK_EQUAL(receiver_->inbox.size(), 2);
+        }
+    }
+
+    ///
+    /// \brief  Parallel delivery must fill inboxes in the same order as
+    ///         sequential delivery.
+    ///
+    BOOST_AUTO_TEST_CASE(environment_parallel_delivery_order)
+    {
+        auto inboxes_ = [](unsigned int threads) {
+            computation::environment e;
+            test_model tm(e, parameter::parametrization(0, 0, 100, 0, threads));
+
+            std::vector<std::shared_ptr<broadcasting_agent>> agents_;
+            for(size_t i = 0; i < 200; ++i) {
+                agents_.push_back(tm.create<broadcasting_agent>());
+            }
+            for(size_t i = 0; i < agents_.size(); ++i) {
+                for(size_t k = 0; k < 10; ++k) {
+                    auto j = (i * 7 + k * k) % agents_.size();
+                    agents_[i]->targets.push_back(agents_[j]->identifier);
+                }
+            }
+
+            tm.step({0, 1});
+
+            std::vector<std::vector<std::pair<std::string, time_point>>> result_;
+            for(auto &a : agents_) {
+                result_.emplace_back();
+                for(auto &[t, m] : a->inbox) {
+                    result_.back().emplace_back(m->sender.representation(), m->sent);
+                }
+            }
+            return result_;
+        };
+
+        auto sequential_ = inboxes_(1);
+        auto parallel_   = inboxes_(4);
+        size_t messages_ = 0;
+        for(const auto &inbox_ : parallel_) {
+            messages_ += inbox_.size();
+        }
+        BOOST_CHECK_EQUAL(messages_, 200 * 10);
+        BOOST_CHECK(sequential_ == parallel_);
+    }
+
+    ///
+    /// \brief  In event activated models, recipients are woken in the order
+    ///         of the sequential delivery, so that the agents they message
+    ///         next receive them in the same order for any number of threads.
+    ///
+    BOOST_AUTO_TEST_CASE(environment_parallel_delivery_order_by_event)
+    {
+        auto received_ = [](unsigned int threads) {
+            computation::environment e;
+            test_model tm(e, parameter::parametrization(0, 0, 100, 0, threads
+                                                       , model::static_partition
+                                                       , model::by_event));
+            auto sink_ = tm.create<counting_agent>();
+            sink_->delay = 1000;
+
+            std::vector<std::shared_ptr<relaying_agent>> relays_;
+            for(size_t i = 0; i < 50; ++i) {
+                relays_.push_back(tm.create<relaying_agent>());
+                relays_.back()->sink = sink_->identifier;
+            }
+            for(size_t i = 0; i < 20; ++i) {
+                auto source_ = tm.create<broadcasting_agent>();
+                for(size_t k = 0; k < 5; ++k) {
+                    auto j = (i * 7 + k * k * 13) % relays_.size();
+                    source_->targets.push_back(relays_[j]->identifier);
+                }
+            }
+
+            tm.step({0, 100});
+            tm.step({1, 100});
+
+            std::vector<std::string> result_;
+            for(auto &[t, m] : sink_->inbox) {
+                result_.push_back(m->sender.representation());
+            }
+            return result_;
+        };
+
+        auto sequential_ = received_(1);
+        BOOST_CHECK(!sequential_.empty());
+        for(unsigned int threads : {2u, 4u}) {
+            BOOST_CHECK(sequential_ == received_(threads));
+        }
+    }
+
+    ///
+    /// \brief  Local agents get dense handles, which are reused after the
+    ///         agent is deactivated, and are found by identity.
+    ///
+    BOOST_AUTO_TEST_CASE(environment_agent_handles)
+    {
+        computation::environment e;
+        test_model tm(e, parameter::parametrization(0, 0, 100));
+
+        std::vector<std::shared_ptr<test_agent>> agents_;
+        for(size_t i = 0; i < 100; ++i) {
+            agents_.push_back(tm.create<test_agent>());
+            agents_.back()->delay = 1;
+            BOOST_CHECK_EQUAL(agents_.back()->handle(), i);
+        }
+        BOOST_CHECK_EQUAL(tm.agents.slots().size(), 100);
+        for(auto &a : agents_) {
+            BOOST_CHECK_EQUAL(tm.agents.find(a->identifier), a.get());
+            BOOST_CHECK_EQUAL(tm.agents.get(a->handle()), a.get());
+        }
+
+        auto removed_ = agents_[42];
+        tm.agents.deactivate(removed_);
+        BOOST_CHECK_EQUAL(removed_->handle(), invalid_handle);
+        BOOST_CHECK(nullptr == tm.agents.find(removed_->identifier));
+        BOOST_CHECK(nullptr == tm.agents.get(42));
+        BOOST_CHECK_EQUAL(tm.agents.handle(removed_->identifier), invalid_handle);
+
+        auto reused_ = tm.create<test_agent>();
+        reused_->delay = 1;
+        BOOST_CHECK_EQUAL(reused_->handle(), 42);
+        BOOST_CHECK_EQUAL(tm.agents.find(reused_->identifier), reused_.get());
+        BOOST_CHECK_EQUAL(tm.agents.find(agents_[43]->identifier), agents_[43].get());
+        BOOST_CHECK_EQUAL(tm.agents.slots().size(), 100);
+
+        // agents are still run after handles are reused
+        BOOST_CHECK_EQUAL(tm.step({0, 1}), 1);
+    }
+
+    ///
+    /// \brief  The random numbers agents draw do not depend on the number of
+    ///         threads, and differ between agents and time steps.
+    ///
+    BOOST_AUTO_TEST_CASE(environment_random_streams)
+    {
+        auto draws_ = [](unsigned int threads) {
+            computation::environment e;
+            test_model tm(e, parameter::parametrization(0, 0, 100, 0, threads));
+
+            std::vector<std::shared_ptr<drawing_agent>> agents_;
+            for(size_t i = 0; i < 50; ++i) {
+                agents_.push_back(tm.create<drawing_agent>());
+            }
+            tm.step({0, 1});
+            tm.step({1, 2});
+
+            std::vector<std::vector<std::uint32_t>> result_;
+            for(auto &a : agents_) {
+                result_.push_back(a->drawn);
+            }
+            return result_;
+        };
+
+        auto sequential_ = draws_(1);
+        BOOST_CHECK(sequential_ == draws_(4));
+        BOOST_CHECK(sequential_[0] != sequential_[1]);
+        BOOST_REQUIRE_EQUAL(sequential_[0].size(), 4);
+        BOOST_CHECK(sequential_[0][0] != sequential_[0][2]);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()  // ESL
@@ -0,0 +1,96 @@
+/// \file   test_hierarchical_bitmap.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE hierarchical_bitmap
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <random>
+#include <set>
+
+#include <esl/computation/hierarchical_bitmap.hpp>
+using esl::computation::hierarchical_bitmap;
+
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(hierarchical_bitmap_empty)
+    {
+        hierarchical_bitmap b_(1000);
+        BOOST_CHECK(b_.empty());
+        BOOST_CHECK_EQUAL(b_.next(0), hierarchical_bitmap::npos);
+        BOOST_CHECK_EQUAL(b_.previous(999), hierarchical_bitmap::npos);
+
+        b_.set(999);
+        BOOST_CHECK(!b_.empty());
+        BOOST_CHECK_EQUAL(b_.next(0), 999);
+        BOOST_CHECK_EQUAL(b_.previous(5000), 999);
+        b_.reset(999);
+        BOOST_CHECK(b_.empty());
+    }
+
+    ///
+    /// \brief  Compares searches with an ordered set, on a bitmap large
+    ///         enough to have four levels
+    ///
+    BOOST_AUTO_TEST_CASE(hierarchical_bitmap_search)
+    {
+        const std::size_t size_ = 64 * 64 * 64 + 1000;
+        hierarchical_bitmap b_(size_);
+        std::set<std::size_t> reference_;
+        std::mt19937_64 generator_(42);
+
+        for(size_t i = 0; i < 2000; ++i) {
+            auto position_ = generator_() % size_;
+            if(generator_() % 3) {
+                b_.set(position_);
+                reference_.insert(position_);
+            } else {
+                b_.reset(position_);
+                reference_.erase(position_);
+            }
+        }
+
+        for(size_t i = 0; i < 2000; ++i) {
+            auto position_ = generator_() % size_;
+            BOOST_CHECK_EQUAL(b_.test(position_), reference_.count(position_) == 1);
+
+            auto after_ = reference_.lower_bound(position_);
+            BOOST_CHECK_EQUAL(b_.next(position_),
+                after_ == reference_.end() ? hierarchical_bitmap::npos : *after_);
+
+            auto before_ = reference_.upper_bound(position_);
+            BOOST_CHECK_EQUAL(b_.previous(position_),
+                before_ == reference_.begin() ? hierarchical_bitmap::npos : *(--before_));
+        }
+
+        for(auto p: reference_) {
+            b_.reset(p);
+        }
+        BOOST_CHECK(b_.empty());
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
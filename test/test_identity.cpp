@@ -155,5 +155,56 @@ BOOST_AUTO_TEST_CASE(identity_equality_different_types)
     BOOST_CHECK(!(i > j));
 }
 
+BOOST_AUTO_TEST_CASE(identity_deep_hierarchy)
+{
+    // longer than the inline capacity, so stored on the heap
+    esl::identity<dummy_base> i = {1, 2, 3, 4, 5, 6};
+    esl::identity<dummy_base> j = i;
+    BOOST_CHECK_EQUAL(i, j);
+    BOOST_CHECK_EQUAL(j.digits.size(), 6);
+    BOOST_CHECK_EQUAL(j.digits.back(), 6);
+
+    esl::identity<dummy_base> k = std::move(j);
+    BOOST_CHECK_EQUAL(i, k);
+    BOOST_CHECK(j.digits.empty());
+
+    j = k;
+    BOOST_CHECK_EQUAL(i, j);
+    k = esl::identity<dummy_base>({1, 2});
+    BOOST_CHECK_EQUAL(k.representation(), "\"1-2\"");
+}
+
+BOOST_AUTO_TEST_CASE(identity_hash)
+{
+    // the hash of a one-digit identity is the digit itself, and otherwise
+    // combines the digits from least to most significant
+    esl::identity<dummy_base> i = {7};
+    BOOST_CHECK_EQUAL(std::hash<esl::identity<dummy_base>>()(i), 7);
+
+    for(std::vector<std::uint64_t> digits_ : {std::vector<std::uint64_t>{1, 2, 3}
+                                             , std::vector<std::uint64_t>{1, 2, 3, 4, 5, 6}}) {
+        std::size_t seed_ = digits_.back();
+        for(auto d = digits_.rbegin() + 1; d != digits_.rend(); ++d) {
+            boost::hash_combine(seed_, *d);
+        }
+        esl::identity<dummy_base> j(digits_);
+        BOOST_CHECK_EQUAL(std::hash<esl::identity<dummy_base>>()(j), seed_);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(identity_create_child)
+{
+    struct parent_t
+    {
+        std::uint64_t children_ = 0;
+    } parent_;
+
+    esl::identity<dummy_base> i = {1, 2, 3, 4};
+    auto c0 = i.create<dummy_base>(parent_);
+    auto c1 = i.create<dummy_base>(parent_);
+    BOOST_CHECK_EQUAL(c0, esl::identity<dummy_base>({1, 2, 3, 4, 0}));
+    BOOST_CHECK_EQUAL(c1, esl::identity<dummy_base>({1, 2, 3, 4, 1}));
+    BOOST_CHECK_EQUAL(parent_.children_, 2);
+}
 
 BOOST_AUTO_TEST_SUITE_END()  // ESL
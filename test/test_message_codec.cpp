@@ -0,0 +1,203 @@
+/// \file   test_message_codec.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE message_codec
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/serialization/export.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/exception.hpp>
+#include <esl/interaction/message.hpp>
+#include <esl/interaction/message_codec.hpp>
+#include <esl/interaction/transfer.hpp>
+
+using namespace esl;
+using namespace esl::interaction;
+
+
+struct numbers_message
+: public message<numbers_message, (std::uint64_t(0x1) << 62u) | 10>
+{
+    std::vector<int> numbers;
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("message",
+            boost::serialization::base_object<
+                message<numbers_message, (std::uint64_t(0x1) << 62u) | 10>>(*this));
+        archive &BOOST_SERIALIZATION_NVP(numbers);
+    }
+};
+
+struct text_message
+: public message<text_message, (std::uint64_t(0x1) << 62u) | 11>
+{
+    std::string text;
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("message",
+            boost::serialization::base_object<
+                message<text_message, (std::uint64_t(0x1) << 62u) | 11>>(*this));
+        archive &BOOST_SERIALIZATION_NVP(text);
+    }
+};
+
+struct unregistered_message
+: public message<unregistered_message, (std::uint64_t(0x1) << 62u) | 12>
+{
+
+};
+
+///
+/// \brief  Not registered, but exported as models did before the codec
+///
+struct exported_message
+: public message<exported_message, (std::uint64_t(0x1) << 62u) | 13>
+{
+    std::string text;
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("message",
+            boost::serialization::base_object<
+                message<exported_message, (std::uint64_t(0x1) << 62u) | 13>>(*this));
+        archive &BOOST_SERIALIZATION_NVP(text);
+    }
+};
+
+BOOST_CLASS_EXPORT(exported_message)
+
+static const bool numbers_registered_ =
+    message_codec::register_message<numbers_message>();
+
+static const bool text_registered_ =
+    message_codec::register_message<text_message>();
+
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(message_codec_round_trip)
+    {
+        BOOST_CHECK(numbers_registered_ && text_registered_);
+        BOOST_CHECK(message_codec::registered(numbers_message::code));
+        BOOST_CHECK(!message_codec::registered(unregistered_message::code));
+
+        auto n = std::make_shared<numbers_message>();
+        n->sender    = identity<agent>({1, 2});
+        n->recipient = identity<agent>({3, 4, 5, 6, 7});
+        n->sent      = 4;
+        n->received  = 5;
+        n->numbers   = {1, 2, 3};
+
+        auto t = std::make_shared<text_message>();
+        t->sender    = identity<agent>({8});
+        t->recipient = identity<agent>({9});
+        t->text      = "quote";
+
+        std::string buffer_;
+        message_codec::encode({n, t, n}, buffer_);
+
+        std::vector<std::shared_ptr<header>> decoded_;
+        auto count_ = message_codec::decode(buffer_.data(), buffer_.size(),
+            [&](std::shared_ptr<header> m) { decoded_.push_back(std::move(m)); });
+
+        BOOST_CHECK_EQUAL(count_, 3);
+        BOOST_REQUIRE_EQUAL(decoded_.size(), 3);
+
+        auto n2 = std::dynamic_pointer_cast<numbers_message>(decoded_[0]);
+        BOOST_REQUIRE(n2);
+        BOOST_CHECK_EQUAL(n2->type, numbers_message::code);
+        BOOST_CHECK_EQUAL(n2->sender, n->sender);
+        BOOST_CHECK_EQUAL(n2->recipient, n->recipient);
+        BOOST_CHECK_EQUAL(n2->sent, 4);
+        BOOST_CHECK_EQUAL(n2->received, 5);
+        BOOST_CHECK(n2->numbers == n->numbers);
+
+        auto t2 = std::dynamic_pointer_cast<text_message>(decoded_[1]);
+        BOOST_REQUIRE(t2);
+        BOOST_CHECK_EQUAL(t2->text, "quote");
+        BOOST_CHECK_EQUAL(t2->recipient, t->recipient);
+
+        // the same message sent twice arrives as two messages
+        auto n3 = std::dynamic_pointer_cast<numbers_message>(decoded_[2]);
+        BOOST_REQUIRE(n3);
+        BOOST_CHECK(n3 != n2);
+        BOOST_CHECK(n3->numbers == n->numbers);
+    }
+
+    BOOST_AUTO_TEST_CASE(message_codec_exported)
+    {
+        BOOST_CHECK(!message_codec::registered(exported_message::code));
+
+        auto e = std::make_shared<exported_message>();
+        e->recipient = identity<agent>({1});
+        e->text      = "exported";
+        auto n = std::make_shared<numbers_message>();
+        n->numbers = {4};
+
+        std::string buffer_;
+        message_codec::encode({e, n}, buffer_);
+
+        std::vector<std::shared_ptr<header>> decoded_;
+        message_codec::decode(buffer_.data(), buffer_.size(),
+            [&](std::shared_ptr<header> m) { decoded_.push_back(std::move(m)); });
+        BOOST_REQUIRE_EQUAL(decoded_.size(), 2);
+
+        auto e2 = std::dynamic_pointer_cast<exported_message>(decoded_[0]);
+        BOOST_REQUIRE(e2);
+        BOOST_CHECK_EQUAL(e2->text, "exported");
+        BOOST_CHECK_EQUAL(e2->recipient, e->recipient);
+
+        auto n2 = std::dynamic_pointer_cast<numbers_message>(decoded_[1]);
+        BOOST_REQUIRE(n2);
+        BOOST_CHECK(n2->numbers == n->numbers);
+    }
+
+    ///
+    /// \brief  Library messages are registered without the model doing so
+    ///
+    BOOST_AUTO_TEST_CASE(message_codec_library_messages)
+    {
+        BOOST_CHECK(message_codec::registered(transfer::code));
+    }
+
+    BOOST_AUTO_TEST_CASE(message_codec_unregistered)
+    {
+        std::string buffer_;
+        BOOST_CHECK_THROW(message_codec::encode(
+            {std::make_shared<unregistered_message>()}, buffer_), esl::exception);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
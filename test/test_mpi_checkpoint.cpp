@@ -0,0 +1,253 @@
+/// \file   test_mpi_checkpoint.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifdef WITH_MPI
+
+#include <filesystem>
+#include <map>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/export.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/computation/checkpoint.hpp>
+#include <esl/interaction/message.hpp>
+#include <esl/interaction/message_codec.hpp>
+#include <esl/simulation/model.hpp>
+
+// then, import the class itself
+#define protected public
+#define private public
+#include <esl/computation/distributed/mpi_environment.hpp>
+#undef private
+#undef protected
+
+#include <test/shared_mpi_ring.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace esl;
+using namespace esl::computation::distributed;
+
+
+struct ring_message
+: public interaction::message<ring_message, (std::uint64_t(0x1) << 62u) | 26>
+{
+    std::uint32_t number = 0;
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("message",
+            boost::serialization::base_object<interaction::message<
+                ring_message, (std::uint64_t(0x1) << 62u) | 26>>(*this));
+        archive &BOOST_SERIALIZATION_NVP(number);
+    }
+};
+
+// messages in inboxes are saved with their recipient
+BOOST_CLASS_EXPORT(ring_message)
+
+static const bool ring_registered_ =
+    interaction::message_codec::register_message<ring_message>();
+
+///
+/// \brief  Draws a random number every round, and sends it to the agent
+///         with the same index on the next process.
+///
+struct ring_agent
+: public agent
+{
+    identity<agent> partner;
+
+    std::vector<std::uint32_t> received;
+
+    std::vector<std::uint32_t> drawn;
+
+    ring_agent()
+    {
+        setup();
+    }
+
+    explicit ring_agent(const identity<ring_agent> &i)
+    : agent(i)
+    {
+        setup();
+    }
+
+    void setup()
+    {
+        std::function<simulation::time_point(std::shared_ptr<ring_message>,
+                                             simulation::time_interval,
+                                             std::seed_seq &)> receive_ =
+            [this](std::shared_ptr<ring_message> m,
+                   simulation::time_interval step, std::seed_seq &seed) {
+                (void)seed;
+                received.push_back(m->number);
+                return step.upper;
+            };
+        register_callback<ring_message>(receive_);
+    }
+
+    simulation::time_point act(simulation::time_interval step,
+                               std::seed_seq &seed) override
+    {
+        (void)seed;
+        drawn.push_back(std::uint32_t(rng()));
+        auto m = create_message<ring_message>(partner, step.lower + 1);
+        m->sender = identifier;
+        m->number = drawn.back();
+        return step.lower + 1;
+    }
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("agent",
+            boost::serialization::base_object<agent>(*this));
+        archive &BOOST_SERIALIZATION_NVP(partner);
+        archive &BOOST_SERIALIZATION_NVP(received);
+        archive &BOOST_SERIALIZATION_NVP(drawn);
+    }
+};
+
+BOOST_CLASS_EXPORT(ring_agent)
+
+constexpr unsigned int agents_ = 3;
+
+///
+/// \brief  Creates the agents of this process, and connects them to those
+///         on the next process.
+///
+void create_agents(mpi_environment &e, simulation::model &m)
+{
+    std::vector<identity<agent>> next_;
+    auto local_ = create_ring<ring_agent>(m, e.communicator_, agents_, next_);
+    for(unsigned int i = 0; i < agents_; ++i) {
+        local_[i]->partner = next_[i];
+    }
+}
+
+///
+/// \brief  The state of the local agents, by identity
+///
+std::map<identity<agent>, std::vector<std::vector<std::uint32_t>>>
+    state(simulation::model &m)
+{
+    std::map<identity<agent>, std::vector<std::vector<std::uint32_t>>> result_;
+    for(auto *a : m.agents.slots()) {
+        if(nullptr != a) {
+            auto *r = dynamic_cast<ring_agent *>(a);
+            auto received_ = r->received;
+            std::sort(received_.begin(), received_.end());
+            result_[r->identifier] = {received_, r->drawn};
+        }
+    }
+    return result_;
+}
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    // the environments are alive at the same time, as MPI is finalized
+    // when the first is destroyed
+    mpi_environment uninterrupted_;
+    mpi_environment first_;
+    mpi_environment second_;
+    const int rank_ = first_.communicator_.rank();
+
+    auto path_ = (std::filesystem::temp_directory_path()
+                 / "esl_test_mpi_checkpoint").string();
+    const auto file_ = path_ + "." + std::to_string(rank_);
+    for(const auto *suffix_ : {"", ".previous", ".partial"}) {
+        std::filesystem::remove(file_ + suffix_);
+    }
+    first_.checkpoints.path     = path_;
+    first_.checkpoints.interval = 4;
+    second_.checkpoints.path    = path_;
+
+    constexpr simulation::time_point end_ = 10;
+    auto parameters_ = simulation::parameter::parametrization(0, 0, end_);
+
+    simulation::model expected_(uninterrupted_, parameters_);
+    create_agents(uninterrupted_, expected_);
+    uninterrupted_.run(expected_);
+
+    simulation::model stopped_(first_, parameters_);
+    create_agents(first_, stopped_);
+    first_.run(stopped_);
+
+    // the resumed model starts from the snapshot at 8
+    simulation::model resumed_(second_, parameters_);
+    create_agents(second_, resumed_);
+    second_.run(resumed_);
+
+    int failed_ = 0;
+    if(computation::checkpoint::peek(file_) != simulation::time_point(8)) {
+        std::cerr << "rank " << rank_ << ": no snapshot at 8" << std::endl;
+        failed_ = 1;
+    }
+    if(state(expected_) != state(stopped_)
+       || state(expected_) != state(resumed_)) {
+        std::cerr << "rank " << rank_ << ": the resumed run differs"
+                  << std::endl;
+        failed_ = 1;
+    }
+    for(const auto &[i, s] : state(resumed_)) {
+        if(s[1].size() != end_) {
+            std::cerr << "rank " << rank_ << ": agent " << i
+                      << " did not run every step" << std::endl;
+            failed_ = 1;
+        }
+    }
+    // every process knows where all agents are again
+    if(second_.agent_locations_.size()
+       != agents_ * size_t(second_.communicator_.size())) {
+        std::cerr << "rank " << rank_ << ": "
+                  << second_.agent_locations_.size() << " agent locations"
+                  << std::endl;
+        failed_ = 1;
+    }
+
+    for(const auto *suffix_ : {"", ".previous"}) {
+        std::filesystem::remove(file_ + suffix_);
+    }
+    return failed_;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+#endif
@@ -105,8 +105,12 @@ public:
     ///
     ///
     /// \return
-    virtual std::vector<migration> migrate_agents() override
+    std::vector<migration>
+    migrate_agents(esl::simulation::model &simulation,
+                   const std::vector<std::int64_t> &loads) override
     {
+        (void)simulation;
+        (void)loads;
         auto result_ = std::vector<migration>(migrate_);
         migrate_.clear();
         return result_;
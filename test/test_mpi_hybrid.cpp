@@ -0,0 +1,248 @@
+/// \file   test_mpi_hybrid.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifdef WITH_MPI
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/interaction/message.hpp>
+#include <esl/simulation/model.hpp>
+
+// then, import the class itself
+#define protected public
+#define private public
+#include <esl/computation/distributed/mpi_environment.hpp>
+#undef private
+#undef protected
+
+#include <test/shared_mpi_ring.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+using namespace esl;
+using namespace esl::computation::distributed;
+
+
+///
+/// \brief  Sent only between agents on the same process
+///
+struct hello_message
+: public interaction::message<hello_message, (std::uint64_t(0x1) << 62u) | 23>
+{
+
+};
+
+///
+/// \brief  Created by a `parent_agent`, and counts the messages it receives
+///
+struct child_agent
+: public agent
+{
+    unsigned int received = 0;
+
+    explicit child_agent(const identity<child_agent> &i)
+    : agent(i)
+    {
+        activation = on_event;
+        std::function<simulation::time_point(std::shared_ptr<hello_message>,
+                                             simulation::time_interval,
+                                             std::seed_seq &)> count_ =
+            [this](std::shared_ptr<hello_message> m,
+                   simulation::time_interval step, std::seed_seq &seed) {
+                (void)m;
+                (void)seed;
+                ++received;
+                return step.upper;
+            };
+        register_callback<hello_message>(count_);
+    }
+
+    simulation::time_point act(simulation::time_interval step,
+                               std::seed_seq &seed) override
+    {
+        (void)seed;
+        // only runs again when it receives a message
+        return step.lower + 100;
+    }
+};
+
+///
+/// \brief  Creates a child in the first step, and messages it in the same
+///         round. Removes the child in the third step.
+///
+/// \details    Agents change the agent collection, so they are serialized,
+///             but they still run on the workers of the model.
+///
+struct parent_agent
+: public agent
+{
+    simulation::model *model = nullptr;
+
+    std::shared_ptr<child_agent> child;
+
+    explicit parent_agent(const identity<parent_agent> &i)
+    : agent(i)
+    {
+        execution = serialized;
+    }
+
+    simulation::time_point act(simulation::time_interval step,
+                               std::seed_seq &seed) override
+    {
+        (void)seed;
+        if(0 == step.lower) {
+            child = model->create<child_agent>(*this);
+            auto m = create_message<hello_message>(child->identifier,
+                                                   step.lower + 1);
+            m->sender = identifier;
+        } else if(2 == step.lower) {
+            model->agents.deactivate(child);
+        }
+        return step.lower + 1;
+    }
+};
+
+///
+/// \return The number of agents the environment locates on each process
+std::vector<unsigned int> located(const mpi_environment &e)
+{
+    std::vector<unsigned int> result_(e.communicator_.size(), 0);
+    for(const auto &[i, n] : e.agent_locations_) {
+        (void)i;
+        ++result_[n];
+    }
+    return result_;
+}
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    mpi_environment e;
+    if(e.environment_.thread_level() < boost::mpi::threading::funneled) {
+        std::cerr << "MPI does not support funneled threads" << std::endl;
+        return 1;
+    }
+    const int rank_ = e.communicator_.rank();
+
+    // processes on the same node share its hardware threads
+    std::vector<std::string> nodes_;
+    boost::mpi::all_gather(e.communicator_, boost::mpi::environment::processor_name(),
+                           nodes_);
+    const auto node_processes_ = unsigned(std::count(nodes_.begin(), nodes_.end(),
+                                                     nodes_[rank_]));
+    const unsigned int hardware_ =
+        std::max(1u, std::thread::hardware_concurrency());
+    if(e.node_processes_ != node_processes_
+       || e.hardware_threads() != std::max(1u, hardware_ / node_processes_)) {
+        std::cerr << "rank " << rank_ << ": " << e.hardware_threads()
+                  << " threads for " << e.node_processes_ << " of "
+                  << node_processes_ << " processes on the node" << std::endl;
+        return 1;
+    }
+    {
+        // zero threads leaves the choice to the environment
+        simulation::model automatic_(e, simulation::parameter::parametrization(
+                                            0, 0, 1, 1, 0));
+        if(automatic_.threads != e.hardware_threads()) {
+            std::cerr << "rank " << rank_ << ": model has " << automatic_.threads
+                      << " threads" << std::endl;
+            return 1;
+        }
+    }
+
+    // two threads per process, sharing agents by work stealing
+    constexpr unsigned int agents_ = 8;
+    simulation::model tm(e, simulation::parameter::parametrization(
+                                0, 0, 3, 1, 2, simulation::model::work_stealing,
+                                simulation::model::by_event));
+    std::vector<identity<agent>> next_;
+    auto parents_ = create_ring<parent_agent>(tm, e.communicator_, agents_, next_);
+    for(auto &p : parents_) {
+        p->model = &tm;
+    }
+    e.activate();
+
+    // the children are created on the workers, and their parents' messages
+    // are dispatched knowing where they are
+    tm.step({0, 1});
+    e.activate();
+    for(auto n : located(e)) {
+        if(2 * agents_ != n) {
+            std::cerr << "rank " << rank_ << ": " << n
+                      << " agents located on a process after creation" << std::endl;
+            return 1;
+        }
+    }
+    for(auto &p : parents_) {
+        if(rank_ != int(e.agent_locations_[p->child->identifier])) {
+            std::cerr << "rank " << rank_ << ": child of agent "
+                      << p->identifier << " is not local" << std::endl;
+            return 1;
+        }
+    }
+
+    tm.step({1, 2});
+    for(auto &p : parents_) {
+        if(1 != p->child->received) {
+            std::cerr << "rank " << rank_ << ": child of agent " << p->identifier
+                      << " received " << p->child->received << " messages"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    // the children are removed on the workers, on all processes
+    tm.step({2, 3});
+    e.deactivate();
+    for(auto n : located(e)) {
+        if(agents_ != n) {
+            std::cerr << "rank " << rank_ << ": " << n
+                      << " agents located on a process after removal" << std::endl;
+            return 1;
+        }
+    }
+    if(agents_ != tm.agents.local_agents_.size()) {
+        std::cerr << "rank " << rank_ << ": " << tm.agents.local_agents_.size()
+                  << " local agents after removal" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,160 @@
+/// \file   test_mpi_load_balance.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifdef WITH_MPI
+
+#include <chrono>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/export.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/simulation/model.hpp>
+
+// then, import the class itself
+#define protected public
+#define private public
+#include <esl/computation/distributed/mpi_environment.hpp>
+#undef private
+#undef protected
+
+#include <iostream>
+
+using namespace esl;
+using namespace esl::computation::distributed;
+
+
+///
+/// \brief  Spends a fixed time computing every round, and counts the rounds.
+///
+struct busy_agent
+: public agent
+{
+    unsigned int rounds = 0;
+
+    busy_agent() = default;
+
+    explicit busy_agent(const identity<busy_agent> &i)
+    : agent(i)
+    {
+
+    }
+
+    simulation::time_point act(simulation::time_interval step,
+                               std::seed_seq &seed) override
+    {
+        (void)seed;
+        auto until_ = std::chrono::high_resolution_clock::now()
+                    + std::chrono::microseconds(200);
+        while(std::chrono::high_resolution_clock::now() < until_) {
+
+        }
+        ++rounds;
+        return step.lower + 1;
+    }
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("agent",
+            boost::serialization::base_object<agent>(*this));
+        archive &BOOST_SERIALIZATION_NVP(rounds);
+    }
+};
+
+BOOST_CLASS_EXPORT(busy_agent)
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    mpi_environment e;
+    e.load_balancing = true;
+    const int rank_  = e.communicator_.rank();
+    const int ranks_ = e.communicator_.size();
+
+    simulation::model tm(e, simulation::parameter::parametrization(0, 0, 100));
+
+    // all agents start on the first process
+    constexpr unsigned int agents_ = 16;
+    if(0 == rank_) {
+        for(unsigned int i = 0; i < agents_; ++i) {
+            tm.create<busy_agent>();
+        }
+    }
+    e.activate();
+
+    constexpr unsigned int steps_ = 6;
+    for(unsigned int t = 0; t < steps_; ++t) {
+        tm.step({t, t + 1});
+    }
+
+    std::vector<std::uint64_t> counts_;
+    boost::mpi::all_gather(e.communicator_,
+                           std::uint64_t(tm.agents.local_agents_.size()),
+                           counts_);
+    std::uint64_t total_ = 0;
+    for(auto c : counts_) {
+        if(1 < ranks_ && 0 == c) {
+            std::cerr << "rank " << rank_ << ": no agents were migrated "
+                      << "to one of the processes" << std::endl;
+            return 1;
+        }
+        total_ += c;
+    }
+    if(agents_ != total_) {
+        std::cerr << "rank " << rank_ << ": " << total_ << " agents"
+                  << std::endl;
+        return 1;
+    }
+
+    // migrated agents keep their state, and run every step exactly once
+    for(auto &[i, a] : tm.agents.local_agents_) {
+        auto b = std::dynamic_pointer_cast<busy_agent>(a);
+        if(!b || steps_ != b->rounds) {
+            std::cerr << "rank " << rank_ << ": agent " << i
+                      << " ran the wrong number of rounds" << std::endl;
+            return 1;
+        }
+        if(rank_ != int(e.agent_locations_[i])) {
+            std::cerr << "rank " << rank_ << ": agent " << i
+                      << " has the wrong location" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+#endif
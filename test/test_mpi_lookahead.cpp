@@ -0,0 +1,180 @@
+/// \file   test_mpi_lookahead.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifdef WITH_MPI
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/interaction/message.hpp>
+#include <esl/interaction/message_codec.hpp>
+#include <esl/simulation/model.hpp>
+
+// then, import the class itself
+#define protected public
+#define private public
+#include <esl/computation/distributed/mpi_environment.hpp>
+#undef private
+#undef protected
+
+#include <test/shared_mpi_ring.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace esl;
+using namespace esl::computation::distributed;
+
+
+struct delayed_message
+: public interaction::message<delayed_message, (std::uint64_t(0x1) << 62u) | 24>
+{
+    std::vector<unsigned int> contents;
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("message",
+            boost::serialization::base_object<interaction::message<
+                delayed_message, (std::uint64_t(0x1) << 62u) | 24>>(*this));
+        archive &BOOST_SERIALIZATION_NVP(contents);
+    }
+};
+
+static const bool delayed_registered_ =
+    interaction::message_codec::register_message<delayed_message>();
+
+constexpr unsigned int agents_ = 2;
+constexpr simulation::time_duration lookahead_ = 3;
+constexpr simulation::time_point end_ = 12;
+
+///
+/// \brief  Acts at every time point, and sends a message to its partner on
+///         the next process that is received `lookahead_` later.
+///
+struct delayed_agent
+: public agent
+{
+    unsigned int index = 0;
+
+    identity<agent> partner;
+
+    std::vector<simulation::time_point> acted;
+
+    std::vector<std::vector<unsigned int>> received;
+
+    bool early = false;
+
+    explicit delayed_agent(const identity<delayed_agent> &i)
+    : agent(i)
+    {
+        std::function<simulation::time_point(std::shared_ptr<delayed_message>,
+                                             simulation::time_interval,
+                                             std::seed_seq &)> record_ =
+            [this](std::shared_ptr<delayed_message> m,
+                   simulation::time_interval step, std::seed_seq &seed) {
+                (void)seed;
+                // a message is never seen before it was sent
+                early = early || step.lower <= m->sent;
+                received.push_back(m->contents);
+                return step.upper;
+            };
+        register_callback<delayed_message>(record_);
+    }
+
+    simulation::time_point act(simulation::time_interval step,
+                               std::seed_seq &seed) override
+    {
+        (void)seed;
+        acted.push_back(step.lower);
+        auto m = create_message<delayed_message>(partner,
+                                                 step.lower + lookahead_);
+        m->sender   = identifier;
+        m->sent     = step.lower;
+        m->contents = {index, unsigned(step.lower)};
+        return step.lower + 1;
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    mpi_environment e;
+    e.lookahead = lookahead_;
+    const int rank_  = e.communicator_.rank();
+    const int ranks_ = e.communicator_.size();
+
+    simulation::model tm(e, simulation::parameter::parametrization(
+        0, 0, end_, 0, 1, simulation::model::static_partition,
+        simulation::model::by_event));
+
+    std::vector<identity<agent>> next_;
+    auto local_ = create_ring<delayed_agent>(tm, e.communicator_, agents_, next_);
+    for(unsigned int i = 0; i < agents_; ++i) {
+        local_[i]->index   = unsigned(rank_) * agents_ + i;
+        local_[i]->partner = next_[i];
+    }
+
+    e.run(tm);
+
+    // every agent acts once at every time point
+    std::vector<simulation::time_point> expected_acted_;
+    for(simulation::time_point t = 0; t < end_; ++t) {
+        expected_acted_.push_back(t);
+    }
+    // messages sent in the last window are not processed
+    const unsigned int source_ = unsigned((rank_ + ranks_ - 1) % ranks_);
+    for(unsigned int i = 0; i < agents_; ++i) {
+        auto &a = local_[i];
+        std::vector<std::vector<unsigned int>> expected_;
+        for(unsigned int t = 0; t + lookahead_ < end_; ++t) {
+            expected_.push_back({source_ * agents_ + i, t});
+        }
+        std::sort(a->received.begin(), a->received.end());
+        if(a->early || a->acted != expected_acted_
+           || a->received != expected_) {
+            std::cerr << "rank " << rank_ << ": agent " << a->index
+                      << " acted " << a->acted.size() << " times and received "
+                      << a->received.size() << " messages, expected "
+                      << expected_acted_.size() << " and "
+                      << expected_.size() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+#endif
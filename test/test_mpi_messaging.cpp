@@ -0,0 +1,183 @@
+/// \file   test_mpi_messaging.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifdef WITH_MPI
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/economics/currencies.hpp>
+#include <esl/economics/markets/walras/quote_message.hpp>
+#include <esl/interaction/message.hpp>
+#include <esl/interaction/message_codec.hpp>
+#include <esl/simulation/model.hpp>
+
+// then, import the class itself
+#define protected public
+#define private public
+#include <esl/computation/distributed/mpi_environment.hpp>
+#undef private
+#undef protected
+
+#include <test/shared_mpi_ring.hpp>
+
+#include <iostream>
+
+using namespace esl;
+using namespace esl::computation::distributed;
+using namespace esl::economics;
+
+
+struct numbers_message
+: public interaction::message<numbers_message, (std::uint64_t(0x1) << 62u) | 20>
+{
+    std::vector<int> numbers;
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("message",
+            boost::serialization::base_object<interaction::message<
+                numbers_message, (std::uint64_t(0x1) << 62u) | 20>>(*this));
+        archive &BOOST_SERIALIZATION_NVP(numbers);
+    }
+};
+
+static const bool numbers_registered_ =
+    interaction::message_codec::register_message<numbers_message>();
+
+///
+/// \brief  Sends its rank to `target` in its first round, and records
+///         what it receives. The rank is also sent as the property quoted
+///         in a library message, which the test does not register.
+///
+struct ping_agent
+: public agent
+{
+    int rank = 0;
+
+    identity<agent> target;
+
+    std::vector<int> received;
+
+    std::vector<std::tuple<identity<law::property>, price>> quoted;
+
+    explicit ping_agent(const identity<ping_agent> &i)
+    : agent(i)
+    {
+        std::function<simulation::time_point(std::shared_ptr<numbers_message>,
+                                             simulation::time_interval,
+                                             std::seed_seq &)> record_ =
+            [this](std::shared_ptr<numbers_message> m,
+                   simulation::time_interval step, std::seed_seq &seed) {
+                (void)seed;
+                received.insert(received.end(), m->numbers.begin(), m->numbers.end());
+                return step.upper;
+            };
+        register_callback<numbers_message>(record_);
+
+        std::function<simulation::time_point(
+            std::shared_ptr<markets::walras::quote_message>,
+            simulation::time_interval, std::seed_seq &)> quoted_ =
+            [this](std::shared_ptr<markets::walras::quote_message> m,
+                   simulation::time_interval step, std::seed_seq &seed) {
+                (void)seed;
+                for(const auto &[p, q] : *m->proposed) {
+                    quoted.emplace_back(p->identifier, std::get<price>(q.type));
+                }
+                return step.upper;
+            };
+        register_callback<markets::walras::quote_message>(quoted_);
+    }
+
+    simulation::time_point act(simulation::time_interval step,
+                               std::seed_seq &seed) override
+    {
+        (void)seed;
+        if(0 == step.lower) {
+            auto m = create_message<numbers_message>(target, step.lower + 1);
+            m->sender  = identifier;
+            m->numbers = {rank, 42};
+
+            law::property_map<markets::quote> quotes_;
+            quotes_.emplace(std::make_shared<law::property>(
+                                identity<law::property>({std::uint64_t(rank)})),
+                            markets::quote(price::approximate(1.25, currencies::USD)));
+            create_message<markets::walras::quote_message>(
+                target, step.lower + 1, identifier, target, quotes_);
+        }
+        return step.lower + 1;
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    mpi_environment e;
+    const int rank_  = e.communicator_.rank();
+    const int ranks_ = e.communicator_.size();
+
+    simulation::model tm(e, simulation::parameter::parametrization(0, 0, 10));
+
+    std::vector<identity<agent>> next_;
+    auto a = create_ring<ping_agent>(tm, e.communicator_, 1, next_).front();
+    a->rank = rank_;
+    a->target = next_.front();
+    e.activate();
+
+    tm.step({0, 1});
+    tm.step({1, 2});
+
+    // every agent received the rank of its predecessor, once
+    const int source_ = (rank_ + ranks_ - 1) % ranks_;
+    if(a->received != std::vector<int>({source_, 42})) {
+        std::cerr << "rank " << rank_ << " did not receive the message from rank "
+                  << source_ << std::endl;
+        return 1;
+    }
+
+    // and the quotes of its predecessor, sent as a library message
+    if(a->quoted.size() != 1
+       || std::get<0>(a->quoted[0]) != identity<law::property>({std::uint64_t(source_)})
+       || std::get<1>(a->quoted[0]) != price::approximate(1.25, currencies::USD)) {
+        std::cerr << "rank " << rank_ << " did not receive the quotes from rank "
+                  << source_ << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,214 @@
+/// \file   test_mpi_partitioning.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifdef WITH_MPI
+
+#include <chrono>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/export.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/interaction/message.hpp>
+#include <esl/interaction/message_codec.hpp>
+#include <esl/simulation/model.hpp>
+
+// then, import the class itself
+#define protected public
+#define private public
+#include <esl/computation/distributed/mpi_environment.hpp>
+#undef private
+#undef protected
+
+#include <test/shared_mpi_ring.hpp>
+
+#include <iostream>
+
+using namespace esl;
+using namespace esl::computation::distributed;
+
+
+struct partner_message
+: public interaction::message<partner_message, (std::uint64_t(0x1) << 62u) | 21>
+{
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("message",
+            boost::serialization::base_object<interaction::message<
+                partner_message, (std::uint64_t(0x1) << 62u) | 21>>(*this));
+    }
+};
+
+// pending messages migrate with their recipient
+BOOST_CLASS_EXPORT(partner_message)
+
+static const bool partner_registered_ =
+    interaction::message_codec::register_message<partner_message>();
+
+///
+/// \brief  Sends a message to its partner every step.
+///
+struct partner_agent
+: public agent
+{
+    identity<agent> partner;
+
+    unsigned int received = 0;
+
+    partner_agent()
+    {
+        listen();
+    }
+
+    explicit partner_agent(const identity<partner_agent> &i)
+    : agent(i)
+    {
+        listen();
+    }
+
+    void listen()
+    {
+        std::function<simulation::time_point(std::shared_ptr<partner_message>,
+                                             simulation::time_interval,
+                                             std::seed_seq &)> count_ =
+            [this](std::shared_ptr<partner_message> m,
+                   simulation::time_interval step, std::seed_seq &seed) {
+                (void)m;
+                (void)seed;
+                ++received;
+                return step.upper;
+            };
+        register_callback<partner_message>(count_);
+    }
+
+    simulation::time_point act(simulation::time_interval step,
+                               std::seed_seq &seed) override
+    {
+        (void)seed;
+        // enough work that the measured cost is not dominated by noise
+        auto until_ = std::chrono::high_resolution_clock::now()
+                    + std::chrono::microseconds(50);
+        while(std::chrono::high_resolution_clock::now() < until_) {
+
+        }
+        auto m = create_message<partner_message>(partner, step.lower);
+        m->sender = identifier;
+        return step.lower + 1;
+    }
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("agent",
+            boost::serialization::base_object<agent>(*this));
+        archive &BOOST_SERIALIZATION_NVP(partner);
+        archive &BOOST_SERIALIZATION_NVP(received);
+    }
+};
+
+BOOST_CLASS_EXPORT(partner_agent)
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    mpi_environment e;
+    e.partition_interval = 4;
+    e.partitioning.tolerance = 0.25;
+    const int rank_  = e.communicator_.rank();
+    const int ranks_ = e.communicator_.size();
+
+    simulation::model tm(e, simulation::parameter::parametrization(0, 0, 100));
+
+    // the partner of an agent is the agent with the same index on the next
+    // process, so that initially all messages cross processes
+    constexpr unsigned int agents_ = 8;
+    std::vector<identity<agent>> next_;
+    auto local_ = create_ring<partner_agent>(tm, e.communicator_, agents_, next_);
+    for(unsigned int i = 0; i < agents_; ++i) {
+        local_[i]->partner = next_[i];
+    }
+    e.activate();
+    // the partner's partner is on the previous process, so only for two
+    // processes do all pairs talk both ways
+    local_.clear();
+
+    constexpr unsigned int steps_ = 6;
+    for(unsigned int t = 0; t < steps_; ++t) {
+        tm.step({t, t + 1});
+    }
+
+    std::vector<std::uint64_t> counts_;
+    boost::mpi::all_gather(e.communicator_,
+                           std::uint64_t(tm.agents.local_agents_.size()),
+                           counts_);
+    std::uint64_t total_ = 0;
+    for(auto c : counts_) {
+        total_ += c;
+    }
+    if(total_ != agents_ * ranks_) {
+        std::cerr << "rank " << rank_ << ": " << total_ << " agents" << std::endl;
+        return 1;
+    }
+
+    // all agents must keep running and receiving after they migrated
+    for(auto &[i, a] : tm.agents.local_agents_) {
+        auto p = std::dynamic_pointer_cast<partner_agent>(a);
+        if(!p || 0 == p->received) {
+            std::cerr << "rank " << rank_ << ": agent " << i
+                      << " received no messages" << std::endl;
+            return 1;
+        }
+        if(2 == ranks_ && rank_ != int(e.agent_locations_[p->partner])) {
+            std::cerr << "rank " << rank_ << ": agent " << i
+                      << " is not with its partner" << std::endl;
+            return 1;
+        }
+    }
+    // balanced within the partitioner's tolerance
+    for(auto c : counts_) {
+        if(double(c) > (1.0 + e.partitioning.tolerance) * agents_ + 1) {
+            std::cerr << "rank " << rank_ << ": unbalanced, " << c
+                      << " agents on a process" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+#endif
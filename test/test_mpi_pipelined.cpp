@@ -0,0 +1,211 @@
+/// \file   test_mpi_pipelined.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifdef WITH_MPI
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/agent.hpp>
+#include <esl/interaction/message.hpp>
+#include <esl/interaction/message_codec.hpp>
+#include <esl/simulation/model.hpp>
+
+// then, import the class itself
+#define protected public
+#define private public
+#include <esl/computation/distributed/mpi_environment.hpp>
+#undef private
+#undef protected
+
+#include <test/shared_mpi_ring.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+using namespace esl;
+using namespace esl::computation::distributed;
+
+
+struct sequence_message
+: public interaction::message<sequence_message, (std::uint64_t(0x1) << 62u) | 22>
+{
+    std::vector<unsigned int> numbers;
+
+    template<class archive_t>
+    void serialize(archive_t &archive, const unsigned int version)
+    {
+        (void)version;
+        archive &boost::serialization::make_nvp("message",
+            boost::serialization::base_object<interaction::message<
+                sequence_message, (std::uint64_t(0x1) << 62u) | 22>>(*this));
+        archive &BOOST_SERIALIZATION_NVP(numbers);
+    }
+};
+
+static const bool sequence_registered_ =
+    interaction::message_codec::register_message<sequence_message>();
+
+constexpr unsigned int agents_   = 8;
+constexpr unsigned int messages_ = 5;
+
+///
+/// \brief  Sends a numbered sequence of messages to each target every step,
+///         and records the sequences it receives.
+///
+struct sequence_agent
+: public agent
+{
+    unsigned int index = 0;
+
+    std::vector<identity<agent>> targets;
+
+    std::vector<std::vector<unsigned int>> received;
+
+    explicit sequence_agent(const identity<sequence_agent> &i)
+    : agent(i)
+    {
+        std::function<simulation::time_point(std::shared_ptr<sequence_message>,
+                                             simulation::time_interval,
+                                             std::seed_seq &)> record_ =
+            [this](std::shared_ptr<sequence_message> m,
+                   simulation::time_interval step, std::seed_seq &seed) {
+                (void)seed;
+                received.push_back(m->numbers);
+                return step.upper;
+            };
+        register_callback<sequence_message>(record_);
+    }
+
+    simulation::time_point act(simulation::time_interval step,
+                               std::seed_seq &seed) override
+    {
+        (void)seed;
+        for(const auto &t : targets) {
+            for(unsigned int k = 0; k < messages_; ++k) {
+                auto m = create_message<sequence_message>(t, step.lower + 1);
+                m->sender  = identifier;
+                m->numbers = {index, k};
+            }
+        }
+        return step.lower + 1;
+    }
+};
+
+///
+/// \brief  Runs agents that message all agents on the next process, with
+///         `threads` threads per process, in a fresh environment.
+///
+/// \return Whether every agent received all messages from the previous
+///         process
+bool run_ring(mpi_environment &e, unsigned int threads)
+{
+    if(1 < threads
+       && e.environment_.thread_level() < boost::mpi::threading::funneled) {
+        std::cerr << "MPI does not support funneled threads" << std::endl;
+        return false;
+    }
+    // messages are sent in many small chunks while agents compute, by the
+    // main thread when the model has workers
+    e.message_chunk = 2;
+    const int rank_  = e.communicator_.rank();
+    const int ranks_ = e.communicator_.size();
+
+    constexpr unsigned int steps_ = 4;
+    // workers share the agents by work stealing
+    simulation::model tm(e, simulation::parameter::parametrization(
+                                0, 0, steps_, 1, threads,
+                                simulation::model::work_stealing));
+    if(threads != tm.threads) {
+        return false;
+    }
+
+    // every agent sends to all agents on the next process
+    std::vector<identity<agent>> next_;
+    auto local_ = create_ring<sequence_agent>(tm, e.communicator_, agents_, next_);
+    for(unsigned int i = 0; i < agents_; ++i) {
+        local_[i]->index   = unsigned(rank_) * agents_ + i;
+        local_[i]->targets = next_;
+    }
+
+    e.run(tm);
+
+    // messages sent in the last step are not processed. Agents process
+    // their messages in random order, so only the contents are compared
+    const unsigned int source_ = unsigned((rank_ + ranks_ - 1) % ranks_);
+    std::vector<std::vector<unsigned int>> expected_;
+    for(unsigned int i = 0; i < agents_; ++i) {
+        for(unsigned int k = 0; k < messages_; ++k) {
+            for(unsigned int t = 0; t + 1 < steps_; ++t) {
+                expected_.push_back({source_ * agents_ + i, k});
+            }
+        }
+    }
+    for(auto &a : local_) {
+        std::sort(a->received.begin(), a->received.end());
+        if(a->received != expected_) {
+            std::cerr << "rank " << rank_ << ", " << threads << " threads: "
+                      << "agent " << a->index << " received "
+                      << a->received.size() << " messages, expected "
+                      << expected_.size() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    // MPI is finalized when the first environment is destroyed, so both
+    // live until the end
+    mpi_environment sequential_;
+    mpi_environment hybrid_;
+    // all processes decide together whether to continue, so that no process
+    // waits in the second run for one that stopped
+    auto passed_ = [](mpi_environment &e, bool local) {
+        return boost::mpi::all_reduce(e.communicator_, local,
+                                      std::logical_and<bool>());
+    };
+    if(!passed_(sequential_, run_ring(sequential_, 1))) {
+        return 1;
+    }
+    if(!passed_(hybrid_, run_ring(hybrid_, 2))) {
+        return 1;
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+#endif
@@ -57,19 +57,19 @@ BOOST_AUTO_TEST_SUITE(ESL)
         auto  max_ = quote(price::approximate(1'0.00, currencies::USD), 100 *  currencies::USD.denominator);
         auto book_ = markets::order_book::static_order_book(min_, max_);
 
-        BOOST_CHECK_EQUAL(book_.ticks,10'000);
+        BOOST_CHECK_EQUAL(book_.tick_size, 1);
 
-        BOOST_CHECK_EQUAL(book_.limits_.size(),999 * 100 + 1);
+        BOOST_CHECK_EQUAL(book_.limits_.size(),999 + 1);
 
         markets::order_book::static_order_book::limit l_;
 
-        book_.default_encode(book_.valid_limits, quote(min_), l_);
+        BOOST_CHECK(book_.encode(quote(min_), l_));
         BOOST_CHECK_EQUAL(l_,0);
 
         markets::order_book::static_order_book::limit u_;
 
-        book_.default_encode(book_.valid_limits, quote(max_), u_);
-        BOOST_CHECK_EQUAL(u_,999 * 100 + 1);
+        BOOST_CHECK(book_.encode(quote(max_), u_));
+        BOOST_CHECK_EQUAL(u_,999);
     }
 
     ///
@@ -172,7 +172,7 @@ BOOST_AUTO_TEST_SUITE(ESL)
             // use nextafter, because otherwise we make floating point errors
             auto q = quote(price::approximate(std::nextafter(p, p+0.01), currencies::USD)
                                    , 100 *  currencies::USD.denominator);
-            BOOST_CHECK(book_.encode(book_.valid_limits, q, l));
+            BOOST_CHECK(book_.encode(q, l));
             auto array_index_ = l;
 
             // testing this seems somewhat redundant, but this can
@@ -182,7 +182,7 @@ BOOST_AUTO_TEST_SUITE(ESL)
             BOOST_CHECK(unique_.find(array_index_) == unique_.end());
             unique_.insert(array_index_);
 
-            auto rtq_ = book_.decode(book_.valid_limits, l);    // round trip value
+            auto rtq_ = book_.decode(l);    // round trip value
             BOOST_CHECK_EQUAL(q, rtq_);
 
 
@@ -190,6 +190,35 @@ BOOST_AUTO_TEST_SUITE(ESL)
 
     }
 
+    ///
+    /// \brief  Books with larger ticks reject limits in between ticks, and
+    ///         report fills at the exact tick
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_tick_size)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::basic_static_order_book<price, 5>(min_, max_);
+
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 200 + 1);
+
+        book_.insert(create_bid(4.76));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        book_.insert(create_bid(4.75));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::invalid);
+
+        // quotes in another lot size are rejected
+        auto other_lot_ = create_bid(4.76);
+        other_lot_.limit.lot = currencies::USD.denominator;
+        book_.insert(other_lot_);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::invalid);
+
+        book_.insert(create_ask(4.71, 500));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::match);
+        BOOST_CHECK_EQUAL(book_.reports.back().limit, quote(price::approximate(4.76, currencies::USD), 100 *  currencies::USD.denominator));
+        BOOST_CHECK_EQUAL(book_.bid().value(), quote(price::approximate(4.76, currencies::USD), 100 *  currencies::USD.denominator));
+    }
+
     BOOST_AUTO_TEST_CASE(statically_allocated_book_placement)
     {
         auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
@@ -312,6 +341,250 @@ BOOST_AUTO_TEST_SUITE(ESL)
 
 
 
+    ///
+    /// \brief  Cancelled orders leave their queue, move the best price when
+    ///         they were the last at the best level, and are skipped when
+    ///         matching
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_cancel)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::static_order_book(min_, max_);
+
+        book_.insert(create_bid(4.75, 100));
+        auto first_ = book_.reports.back().identifier;
+        book_.insert(create_bid(4.75, 200));
+        auto middle_ = book_.reports.back().identifier;
+        book_.insert(create_bid(4.75, 300));
+        book_.insert(create_bid(4.80, 400));
+        auto best_ = book_.reports.back().identifier;
+        BOOST_CHECK_EQUAL(book_.pool_.size(), 4);
+
+        book_.reports.clear();
+        book_.cancel(best_);
+        BOOST_CHECK_EQUAL(book_.reports.size(), 1);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::cancel);
+        BOOST_CHECK_EQUAL(book_.reports.back().side, limit_order_message::buy);
+        BOOST_CHECK_EQUAL(book_.reports.back().quantity, 400);
+        BOOST_CHECK(book_.bid());
+        BOOST_CHECK_EQUAL(book_.bid().value(), quote(price::approximate(4.75, currencies::USD), 100 *  currencies::USD.denominator));
+
+        // cancelling twice is ignored
+        book_.cancel(best_);
+        BOOST_CHECK_EQUAL(book_.reports.size(), 1);
+
+        book_.cancel(middle_);
+        BOOST_CHECK_EQUAL(book_.pool_.size(), 2);
+
+        // the cancelled order in the middle of the queue is skipped
+        book_.reports.clear();
+        book_.insert(create_ask(4.75, 250));
+        BOOST_CHECK_EQUAL(book_.reports.size(), 4);
+        BOOST_CHECK_EQUAL(book_.reports[1].identifier, first_);
+        BOOST_CHECK_EQUAL(book_.reports[1].quantity, 100);
+        BOOST_CHECK_EQUAL(book_.reports[3].quantity, 150);
+        BOOST_CHECK_EQUAL(book_.pool_.size(), 1);
+
+        // filled orders can no longer be cancelled
+        book_.reports.clear();
+        book_.cancel(first_);
+        BOOST_CHECK(book_.reports.empty());
+
+        book_.insert(create_ask(4.75, 150));
+        BOOST_CHECK(!book_.bid());
+        BOOST_CHECK(!book_.ask());
+        BOOST_CHECK_EQUAL(book_.pool_.size(), 0);
+    }
+
+    ///
+    /// \brief  In a wide book with few occupied levels, sweeps and cancels
+    ///         move the best price across empty levels
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_sparse)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10'000.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::static_order_book(min_, max_);
+
+        book_.insert(create_bid(9'000.00, 100));
+        book_.insert(create_bid(5'000.00, 100));
+        book_.insert(create_bid(0.01, 100));
+        auto lowest_ = book_.reports.back().identifier;
+        book_.insert(create_ask(9'999.99, 100));
+
+        book_.insert(create_ask(4'000.00, 150));
+        BOOST_CHECK_EQUAL(book_.bid().value(), quote(price::approximate(5'000.00, currencies::USD), 100 *  currencies::USD.denominator));
+        BOOST_CHECK_EQUAL(book_.reports.back().quantity, 50);
+
+        book_.insert(create_ask(0.01, 50));
+        BOOST_CHECK_EQUAL(book_.bid().value(), quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator));
+
+        book_.cancel(lowest_);
+        BOOST_CHECK(!book_.bid());
+        BOOST_CHECK_EQUAL(book_.ask().value(), quote(price::approximate(9'999.99, currencies::USD), 100 *  currencies::USD.denominator));
+
+        book_.insert(create_bid(9'999.99, 100));
+        BOOST_CHECK(!book_.ask());
+        BOOST_CHECK(book_.occupied_.empty());
+    }
+
+    ///
+    /// \brief  An order resting at the lowest or highest level is not taken
+    ///         for the best price of the other, empty side
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_edge_levels)
+    {
+        auto usd_ = [](double p){
+            return quote(price::approximate(p, currencies::USD), 100 *  currencies::USD.denominator);
+        };
+        auto book_ = markets::order_book::static_order_book(usd_(1.00), usd_(2.00));
+
+        book_.insert(create_ask(1.00, 100));
+        BOOST_CHECK(!book_.bid());
+        BOOST_CHECK_EQUAL(book_.ask().value(), usd_(1.00));
+
+        book_.reports.clear();
+        book_.insert(create_ask(1.00, 50));
+        BOOST_REQUIRE_EQUAL(book_.reports.size(), 1);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        BOOST_CHECK_EQUAL(book_.pool_.size(), 2);
+
+        auto bids_ = markets::order_book::static_order_book(usd_(1.00), usd_(2.00));
+        bids_.insert(create_bid(2.00, 100));
+        BOOST_CHECK(!bids_.ask());
+        BOOST_CHECK_EQUAL(bids_.bid().value(), usd_(2.00));
+
+        bids_.reports.clear();
+        bids_.insert(create_bid(2.00, 50));
+        BOOST_REQUIRE_EQUAL(bids_.reports.size(), 1);
+        BOOST_CHECK_EQUAL(bids_.reports.back().state, execution_report::placement);
+        BOOST_CHECK_EQUAL(bids_.pool_.size(), 2);
+    }
+
+    ///
+    /// \brief  Resizing keeps resting orders inside the new range, with their
+    ///         identifiers, and cancels the others
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_resize)
+    {
+        auto usd_ = [](double p){
+            return quote(price::approximate(p, currencies::USD), 100 *  currencies::USD.denominator);
+        };
+        auto book_ = markets::order_book::static_order_book(usd_(1.00), usd_(2.00));
+
+        book_.insert(create_bid(1.10, 100));
+        auto low_ = book_.reports.back().identifier;
+        book_.insert(create_bid(1.50, 100));
+        auto kept_ = book_.reports.back().identifier;
+        book_.insert(create_ask(1.60, 100));
+        book_.reports.clear();
+
+        book_.resize(mathematics::interval<quote>(usd_(1.20), usd_(3.00)));
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 181);
+        BOOST_REQUIRE_EQUAL(book_.reports.size(), 2);
+        BOOST_CHECK_EQUAL(book_.reports.front().state, execution_report::cancel);
+        BOOST_CHECK_EQUAL(book_.reports.front().identifier, low_);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::resize);
+        BOOST_CHECK_EQUAL(book_.reports.back().limit, usd_(1.20));
+        BOOST_CHECK_EQUAL(book_.reports.back().quantity, 181);
+
+        BOOST_CHECK_EQUAL(book_.bid().value(), usd_(1.50));
+        BOOST_CHECK_EQUAL(book_.ask().value(), usd_(1.60));
+
+        book_.insert(create_ask(2.50, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        book_.insert(create_bid(1.10, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::invalid);
+
+        book_.reports.clear();
+        book_.cancel(kept_);
+        BOOST_REQUIRE_EQUAL(book_.reports.size(), 1);
+        BOOST_CHECK_EQUAL(book_.reports.back().limit, usd_(1.50));
+
+        BOOST_CHECK_THROW(book_.resize(mathematics::interval<quote>(usd_(3.00), usd_(1.00))), esl::exception);
+    }
+
+    ///
+    /// \brief  With automatic resizing, orders outside the range move the
+    ///         range around the resting orders and the new order
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_automatic_resize)
+    {
+        auto usd_ = [](double p){
+            return quote(price::approximate(p, currencies::USD), 100 *  currencies::USD.denominator);
+        };
+        auto book_ = markets::order_book::static_order_book(usd_(1.00), usd_(1.99));
+        book_.automatic_resize = true;
+
+        book_.insert(create_bid(1.50, 100));
+        auto bid_ = book_.reports.back().identifier;
+        book_.insert(create_ask(1.90, 100));
+        book_.reports.clear();
+
+        book_.insert(create_ask(2.50, 100));
+        BOOST_REQUIRE_EQUAL(book_.reports.size(), 2);
+        BOOST_CHECK_EQUAL(book_.reports.front().state, execution_report::resize);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 400);
+        BOOST_CHECK(book_.range().contains(usd_(1.50)));
+        BOOST_CHECK(book_.range().contains(usd_(2.50)));
+
+        // prices drift upwards, far from the original range
+        for(double p = 2.60; p < 20.0; p += 1.00){
+            book_.insert(create_ask(p, 100));
+            BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        }
+        BOOST_CHECK_EQUAL(book_.bid().value(), usd_(1.50));
+        BOOST_CHECK_EQUAL(book_.ask().value(), usd_(1.90));
+
+        book_.insert(create_bid(2.55, 350));
+        BOOST_CHECK_EQUAL(book_.bid().value(), usd_(2.55));
+        BOOST_CHECK_EQUAL(book_.ask().value(), usd_(2.60));
+
+        book_.reports.clear();
+        book_.cancel(bid_);
+        BOOST_REQUIRE_EQUAL(book_.reports.size(), 1);
+        BOOST_CHECK_EQUAL(book_.reports.back().limit, usd_(1.50));
+        BOOST_CHECK_EQUAL(book_.reports.back().quantity, 100);
+    }
+
+    ///
+    /// \brief  Automatic resizing does not grow the book beyond its maximum
+    ///         number of levels, and rejects orders that would need more
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_automatic_resize_limit)
+    {
+        auto usd_ = [](double p){
+            return quote(price::approximate(p, currencies::USD), 100 *  currencies::USD.denominator);
+        };
+        auto book_ = markets::order_book::static_order_book(usd_(1.00), usd_(1.99));
+        book_.automatic_resize = true;
+
+        book_.insert(create_bid(1.50, 100));
+        book_.reports.clear();
+
+        // an order far away from the resting orders
+        book_.insert(create_ask(1'000'000'000.00, 100));
+        BOOST_REQUIRE_EQUAL(book_.reports.size(), 1);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::invalid);
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 100);
+        BOOST_CHECK_EQUAL(book_.range().lower, usd_(1.00));
+
+        book_.maximum_levels = 1000;
+        book_.reports.clear();
+        book_.insert(create_ask(10.00, 100));
+        BOOST_REQUIRE_EQUAL(book_.reports.size(), 1);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::invalid);
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 100);
+
+        book_.insert(create_ask(5.00, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        BOOST_CHECK_LE(book_.limits_.size(), 1000);
+        BOOST_CHECK_EQUAL(book_.bid().value(), usd_(1.50));
+        BOOST_CHECK_EQUAL(book_.ask().value(), usd_(5.00));
+    }
+
     limit_order_message create(double p, size_t q = 1000, limit_order_message::side_t side = limit_order_message::side_t::sell)
     {
         esl::economics::markets::ticker ticker_dummy_;
@@ -355,14 +628,28 @@ BOOST_AUTO_TEST_SUITE(ESL)
             }
         }
 
+        // identifiers of placed orders, some of which are filled before
+        // they are cancelled
+        std::vector<basic_book::order_identifier> placed_;
+        placed_.reserve(messages_.size());
+
         auto t1 = std::chrono::high_resolution_clock::now();
         for(const auto &o: messages_){
 
-            if(0 == generator_() % 5 ){
+            if(0 == generator_() % 5 && !placed_.empty()){
                 // cancel random order
+                auto i = generator_() % placed_.size();
+                book_->cancel(placed_[i]);
+                placed_[i] = placed_.back();
+                placed_.pop_back();
             }
 
             book_->insert(o);
+            for(const auto &r: book_->reports){
+                if(execution_report::placement == r.state){
+                    placed_.push_back(r.identifier);
+                }
+            }
             book_->reports.clear();
         }
         auto t2 = std::chrono::high_resolution_clock::now();
@@ -0,0 +1,122 @@
+/// \file   test_partitioner.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE partitioner
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <esl/computation/distributed/partitioner.hpp>
+
+using namespace esl;
+using namespace esl::computation::distributed;
+
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    ///
+    /// \brief  Two groups of agents that only talk within their group, with
+    ///         the groups dealt out alternately over two processes.
+    ///
+    BOOST_AUTO_TEST_CASE(partitioner_separates_groups)
+    {
+        std::vector<partition_vertex> vertices_;
+        for(std::uint64_t i = 0; i < 8; ++i) {
+            vertices_.push_back({identity<agent>({i}), node_identifier(i % 2), 1.0});
+        }
+        std::vector<partition_edge> edges_;
+        for(std::uint64_t i = 0; i < 8; ++i) {
+            for(std::uint64_t j = i + 1; j < 8; ++j) {
+                if((i < 4) == (j < 4)) {
+                    edges_.push_back({identity<agent>({i}), identity<agent>({j}), 3.0});
+                }
+            }
+        }
+        // a single message between the groups
+        edges_.push_back({identity<agent>({0}), identity<agent>({7}), 1.0});
+
+        partitioner p;
+        auto before_ = std::vector<node_identifier>(8);
+        for(size_t i = 0; i < 8; ++i) {
+            before_[i] = vertices_[i].location;
+        }
+        auto after_ = p.partition(vertices_, edges_, 2);
+
+        BOOST_CHECK_EQUAL(partitioner::cut(vertices_, edges_, after_), 1.0);
+        BOOST_CHECK_LT(partitioner::cut(vertices_, edges_, after_),
+                       partitioner::cut(vertices_, edges_, before_));
+        for(size_t i = 1; i < 4; ++i) {
+            BOOST_CHECK_EQUAL(after_[i], after_[0]);
+            BOOST_CHECK_EQUAL(after_[4 + i], after_[4]);
+        }
+        BOOST_CHECK_NE(after_[0], after_[4]);
+    }
+
+    BOOST_AUTO_TEST_CASE(partitioner_balances_weight)
+    {
+        // all agents start on the first of four processes, and none talk
+        std::vector<partition_vertex> vertices_;
+        for(std::uint64_t i = 0; i < 12; ++i) {
+            vertices_.push_back({identity<agent>({i}), 0, 2.0});
+        }
+
+        partitioner p;
+        p.tolerance = 0.0;
+        auto after_ = p.partition(vertices_, {}, 4);
+
+        std::vector<unsigned int> counts_(4, 0);
+        for(auto n : after_) {
+            BOOST_REQUIRE(0 <= n && n < 4);
+            ++counts_[n];
+        }
+        for(auto c : counts_) {
+            BOOST_CHECK_EQUAL(c, 3);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(partitioner_respects_capacity)
+    {
+        // a star around agent 0: all agents want to join it, but the
+        // process may hold at most half the agents plus the tolerance
+        std::vector<partition_vertex> vertices_;
+        std::vector<partition_edge> edges_;
+        for(std::uint64_t i = 0; i < 10; ++i) {
+            vertices_.push_back({identity<agent>({i}), node_identifier(i % 2), 1.0});
+            if(0 < i) {
+                edges_.push_back({identity<agent>({i}), identity<agent>({0}), 1.0});
+            }
+        }
+
+        partitioner p;
+        p.tolerance = 0.2;
+        auto after_ = p.partition(vertices_, edges_, 2);
+        unsigned int with_centre_ = 0;
+        for(auto n : after_) {
+            with_centre_ += (n == after_[0]);
+        }
+        BOOST_CHECK_LE(with_centre_, 6);
+        BOOST_CHECK_LT(partitioner::cut(vertices_, edges_, after_), 5.0);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
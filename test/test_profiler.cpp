@@ -0,0 +1,118 @@
+/// \file   test_profiler.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE profiler
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <esl/computation/profiler.hpp>
+
+using esl::computation::profiler;
+
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(profiler_buckets)
+    {
+        // every duration falls in a bucket whose upper bound is at least the
+        // duration, and within a quarter above it
+        for(std::uint64_t d : {0ull, 1ull, 3ull, 4ull, 7ull, 8ull, 1000ull,
+                               123456789ull, (1ull << 62u) + 12345ull}) {
+            auto b = profiler::bucket(d);
+            BOOST_CHECK(d <= profiler::bucket_upper(b));
+            BOOST_CHECK(profiler::bucket_upper(b) <= d + d / 4);
+            if(0 < b) {
+                BOOST_CHECK(profiler::bucket_upper(b - 1) < d);
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(profiler_sites_are_shared)
+    {
+        auto &p = profiler::instance();
+        auto a = p.register_site("callback", "message", "file.cpp", 1);
+        auto b = p.register_site("callback", "message", "file.cpp", 2);
+        BOOST_CHECK(a != b);
+        BOOST_CHECK_EQUAL(a, p.register_site("callback", "message", "file.cpp", 1));
+        BOOST_CHECK_EQUAL(p.where(b).line, 2);
+    }
+
+    BOOST_AUTO_TEST_CASE(profiler_aggregates_threads)
+    {
+        auto &p = profiler::instance();
+        p.reset();
+        auto fast_ = p.register_site("fast", "m", "f.cpp", 10);
+        auto slow_ = p.register_site("slow", "m", "f.cpp", 11);
+
+        std::vector<std::thread> threads_;
+        for(unsigned int t = 0; t < 4; ++t) {
+            threads_.emplace_back([&]() {
+                for(unsigned int i = 0; i < 100; ++i) {
+                    p.record(fast_, std::chrono::nanoseconds(10));
+                    // one percent of calls take much longer
+                    p.record(slow_, std::chrono::nanoseconds(i < 99 ? 100 : 100'000));
+                }
+            });
+        }
+        // the main thread is still running when aggregating
+        p.record(fast_, std::chrono::nanoseconds(10));
+        for(auto &t : threads_) {
+            t.join();
+        }
+        p.aggregate();
+
+        auto step_ = p.last_step();
+        BOOST_REQUIRE_EQUAL(step_.size(), 2);
+        for(const auto &s : step_) {
+            if(fast_ == s.id) {
+                BOOST_CHECK_EQUAL(s.calls, 401);
+                BOOST_CHECK_EQUAL(s.total.count(), 4010);
+            }else{
+                BOOST_CHECK_EQUAL(s.calls, 400);
+                BOOST_CHECK(100 <= s.p99.count() && s.p99.count() < 125);
+            }
+        }
+
+        // a step without calls leaves the totals
+        p.aggregate();
+        BOOST_CHECK(p.last_step().empty());
+        BOOST_CHECK_EQUAL(p.totals().size(), 2);
+
+        std::stringstream report_;
+        p.write_report(report_);
+        std::string header_;
+        std::string first_;
+        std::getline(report_, header_);
+        std::getline(report_, first_);
+        BOOST_CHECK_EQUAL(header_, "description,message,file,line,calls,total_ns,p99_ns");
+        // sorted by total time
+        BOOST_CHECK_EQUAL(first_.substr(0, 6), "\"slow\"");
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
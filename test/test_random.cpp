@@ -0,0 +1,113 @@
+/// \file   test_random.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE random
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <random>
+#include <set>
+
+#include <esl/computation/random.hpp>
+
+using esl::computation::random_stream;
+
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(random_philox_known_answers)
+    {
+        // known answer tests from the Random123 distribution
+        auto zero_ = random_stream::block({0, 0, 0, 0}, {0, 0});
+        BOOST_CHECK_EQUAL(zero_[0], 0x6627e8d5u);
+        BOOST_CHECK_EQUAL(zero_[1], 0xe169c58du);
+        BOOST_CHECK_EQUAL(zero_[2], 0xbc57ac4cu);
+        BOOST_CHECK_EQUAL(zero_[3], 0x9b00dbd8u);
+
+        auto ones_ = random_stream::block(
+            {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu},
+            {0xffffffffu, 0xffffffffu});
+        BOOST_CHECK_EQUAL(ones_[0], 0x408f276du);
+        BOOST_CHECK_EQUAL(ones_[1], 0x41c83b0eu);
+        BOOST_CHECK_EQUAL(ones_[2], 0xa20bc7c6u);
+        BOOST_CHECK_EQUAL(ones_[3], 0x6d5451fdu);
+    }
+
+    BOOST_AUTO_TEST_CASE(random_stream_reproducible)
+    {
+        random_stream a(1, 2, 3, 4);
+        random_stream b(1, 2, 3, 4);
+        for(size_t i = 0; i < 100; ++i) {
+            BOOST_CHECK_EQUAL(a(), b());
+        }
+
+        // streams that differ in any part of the key or counter differ
+        std::set<random_stream::result_type> first_;
+        for(std::uint64_t sample = 0; sample < 4; ++sample) {
+            for(std::uint64_t entity = 0; entity < 4; ++entity) {
+                for(std::uint64_t time = 0; time < 4; ++time) {
+                    for(std::uint32_t round = 0; round < 4; ++round) {
+                        first_.insert(random_stream(sample, entity, time, round)());
+                    }
+                }
+            }
+        }
+        BOOST_CHECK_EQUAL(first_.size(), 4 * 4 * 4 * 4);
+    }
+
+    BOOST_AUTO_TEST_CASE(random_stream_discard)
+    {
+        for(unsigned long long n : {0ull, 1ull, 3ull, 4ull, 5ull, 11ull}) {
+            random_stream a(7, 8, 9);
+            random_stream b(7, 8, 9);
+            a();
+            b();
+            for(unsigned long long i = 0; i < n; ++i) {
+                a();
+            }
+            b.discard(n);
+            BOOST_CHECK_EQUAL(a(), b());
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(random_stream_distributions)
+    {
+        random_stream s(0, 1, 2);
+        double sum_ = 0;
+        for(size_t i = 0; i < 10000; ++i) {
+            auto u = s.uniform();
+            BOOST_CHECK(0. <= u && u < 1.);
+            sum_ += u;
+        }
+        BOOST_CHECK_CLOSE(sum_ / 10000, 0.5, 2.);
+
+        std::uniform_int_distribution<int> die_(1, 6);
+        for(size_t i = 0; i < 1000; ++i) {
+            auto d = die_(s);
+            BOOST_CHECK(1 <= d && d <= 6);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
@@ -0,0 +1,103 @@
+/// \file   test_thread_pool.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE thread_pool
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <esl/computation/thread_pool.hpp>
+
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(thread_pool_fork_join_polls_until_done)
+    {
+        esl::computation::thread_pool pool_(2);
+        std::atomic<unsigned int> completed_ = 0;
+        unsigned int polls_ = 0;
+
+        pool_.fork_join(8, [&](unsigned int) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++completed_;
+        }, [&]() {
+            ++polls_;
+            return false;
+        });
+
+        BOOST_CHECK_EQUAL(completed_, 8);
+        BOOST_CHECK_GT(polls_, 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(thread_pool_fork_join_poll_throws)
+    {
+        constexpr unsigned int tasks_ = 4;
+        esl::computation::thread_pool pool_(2);
+        std::atomic<bool> release_ = false;
+        std::atomic<unsigned int> completed_ = 0;
+        unsigned int polls_ = 0;
+
+        // the tasks are still running when poll throws, and only finish
+        // once this thread releases them
+        std::thread releaser_([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            release_ = true;
+        });
+
+        BOOST_CHECK_THROW(pool_.fork_join(tasks_, [&](unsigned int) {
+            while(!release_) {
+                std::this_thread::yield();
+            }
+            ++completed_;
+        }, [&]() -> bool {
+            ++polls_;
+            throw std::runtime_error("poll");
+        }), std::runtime_error);
+
+        // fork_join returned only after all tasks completed
+        BOOST_CHECK_EQUAL(completed_, tasks_);
+        BOOST_CHECK_EQUAL(polls_, 1);
+        releaser_.join();
+    }
+
+    BOOST_AUTO_TEST_CASE(thread_pool_fork_join_rethrows_task_error)
+    {
+        esl::computation::thread_pool pool_(2);
+        std::atomic<unsigned int> completed_ = 0;
+
+        BOOST_CHECK_THROW(pool_.fork_join(4, [&](unsigned int t) {
+            ++completed_;
+            if(0 == t) {
+                throw std::logic_error("task");
+            }
+        }, []() { return false; }), std::logic_error);
+        BOOST_CHECK_EQUAL(completed_, 4);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
@@ -31,6 +31,11 @@
 
 #include <boost/test/included/unit_test.hpp>
 
+#include <sstream>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
 #include <esl/computation/environment.hpp>
 #include <esl/data/log.hpp>
 #include <esl/economics/company.hpp>
@@ -137,10 +142,10 @@ struct test_constant_demand_trader
             case walras::quote_message::code:
                 auto quote_ = std::dynamic_pointer_cast<walras::quote_message>(message_);
                 map<identity<property>, double> allocation;
-                size_t assets_ = quote_->proposed.size();
+                size_t assets_ = quote_->proposed->size();
                 size_t denominator_ =  (assets_ * (1 + assets_))/2;
                 size_t a = 1;
-                for(auto [k, q]: quote_->proposed){
+                for(auto [k, q]: *quote_->proposed){
                     allocation.emplace(k->identifier,  double(a) / denominator_ );
                     ++a;
                 }
@@ -153,7 +158,7 @@ struct test_constant_demand_trader
                                                                                 , *quote_
                                                                                  );
                 message_->sent = step.lower;
-                for(auto [k, q]: quote_->proposed){
+                for(auto [k, q]: *quote_->proposed){
                     message_->supply.emplace(k->identifier, std::make_tuple(500, quantity(0)));
                 }
             }
@@ -393,4 +398,27 @@ BOOST_AUTO_TEST_CASE(walras_market_quote_multiple_assets)
         BOOST_TEST(std::get<price>(market_->traded_properties.find(properties_[0])->second.type) == price(200, currencies::USD));
     }
 
+///
+/// \brief  Tests that a quote message without quotes is saved with an empty
+///         map, and that a loaded message has its own quotes.
+///
+    BOOST_AUTO_TEST_CASE(walras_quote_message_serialization)
+    {
+        std::shared_ptr<const law::property_map<quote>> none_;
+        walras::quote_message saved_(identity<agent>(), identity<agent>(), none_);
+        std::stringstream stream_;
+        {
+            boost::archive::binary_oarchive archive_(stream_);
+            archive_ << saved_;
+        }
+
+        walras::quote_message loaded_(identity<agent>(), identity<agent>(), none_);
+        {
+            boost::archive::binary_iarchive archive_(stream_);
+            archive_ >> loaded_;
+        }
+        BOOST_REQUIRE(loaded_.proposed);
+        BOOST_CHECK(loaded_.proposed->empty());
+    }
+
 BOOST_AUTO_TEST_SUITE_END()  // ESL
@@ -0,0 +1,98 @@
+/// \file   test_work_stealing.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE work_stealing
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <esl/computation/work_stealing.hpp>
+
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(work_stealing_single_worker)
+    {
+        esl::computation::work_stealing ws_(1);
+        ws_.assign(5);
+
+        esl::computation::work_stealing::task_t task_;
+        for(esl::computation::work_stealing::task_t i = 0; i < 5; ++i){
+            BOOST_CHECK(ws_.next(0, task_));
+            BOOST_CHECK_EQUAL(task_, i);
+        }
+        BOOST_CHECK(!ws_.next(0, task_));
+    }
+
+    BOOST_AUTO_TEST_CASE(work_stealing_steals_from_busy_worker)
+    {
+        esl::computation::work_stealing ws_(2);
+        // all work is given to worker 0
+        ws_.assign(0, 0, 10);
+        ws_.assign(1, 0, 0);
+
+        esl::computation::work_stealing::task_t task_;
+        BOOST_CHECK(ws_.next(1, task_));
+        // worker 1 steals the back half
+        BOOST_CHECK_EQUAL(task_, 5);
+        BOOST_CHECK(ws_.next(0, task_));
+        BOOST_CHECK_EQUAL(task_, 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(work_stealing_visits_every_task_once)
+    {
+        constexpr unsigned int workers_ = 4;
+        constexpr esl::computation::work_stealing::task_t tasks_ = 100'000;
+
+        esl::computation::work_stealing ws_(workers_);
+        // skewed initial assignment, so that stealing is needed
+        ws_.assign(0, 0, tasks_ - 3);
+        ws_.assign(1, tasks_ - 3, tasks_ - 2);
+        ws_.assign(2, tasks_ - 2, tasks_ - 1);
+        ws_.assign(3, tasks_ - 1, tasks_);
+
+        std::vector<std::atomic<unsigned int>> visits_(tasks_);
+        std::vector<std::thread> threads_;
+        for(unsigned int w = 0; w < workers_; ++w){
+            threads_.emplace_back([&, w](){
+                esl::computation::work_stealing::task_t task_;
+                while(ws_.next(w, task_)){
+                    ++visits_[task_];
+                }
+            });
+        }
+        for(auto &t: threads_){
+            t.join();
+        }
+
+        for(const auto &v: visits_){
+            BOOST_CHECK_EQUAL(v.load(), 1);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL